@@ -0,0 +1,162 @@
+#include <asteroids/asteroidField.h>
+#include <asteroids/random.h>
+
+#include <cmath>
+
+enum : ezUInt32 { EmptyCell = 0xFFFFFFFFu };
+
+namespace
+{
+  /// \brief All that is needed of a placed asteroid to test candidates against it, in one cache line.
+  struct PlacedDisk
+  {
+    ezVec2 center;
+    float radius;
+    ezUInt32 next; ///< Next disk in the same cell.
+  };
+
+  /// \brief Placed asteroids by cell. Every cell is a linked list running through PlacedDisk::next.
+  struct FieldGrid
+  {
+    float cellSize;
+    ezInt32 numCellsX;
+    ezInt32 numCellsY;
+    ezDynamicArray<ezUInt32> cells; ///< First disk per cell.
+    ezDynamicArray<PlacedDisk> disks;
+  };
+}
+
+static ezInt32 cellCoord(float value, float origin, float cellSize, ezInt32 numCells)
+{
+  auto coord = static_cast<ezInt32>((value - origin) / cellSize);
+  return ezMath::Clamp(coord, 0, numCells - 1);
+}
+
+static int pickLives(const AsteroidFieldDesc& desc, RandomEngine& random)
+{
+  auto totalWeight = 0.0f;
+  for(auto weight : desc.livesWeights)
+  {
+    totalWeight += ezMath::Max(weight, 0.0f);
+  }
+
+  if(totalWeight <= 0.0f)
+  {
+    return Asteroid::NumLives;
+  }
+
+  auto pick = random.uniform(0.0f, totalWeight);
+  for(int i = 0; i < Asteroid::NumLives; ++i)
+  {
+    pick -= ezMath::Max(desc.livesWeights[i], 0.0f);
+    if(pick < 0.0f)
+    {
+      return i + 1;
+    }
+  }
+
+  return Asteroid::NumLives;
+}
+
+static bool isKeptOut(const AsteroidFieldDesc& desc, const ezVec2& position, float radius)
+{
+  if(desc.keepOutRadius > 0.0f
+     && (position - desc.keepOutCenter).GetLengthSquared() < ezMath::Square(desc.keepOutRadius + radius))
+  {
+    return true;
+  }
+
+  return desc.keepOutRect.width > 0.0f
+      && desc.keepOutRect.height > 0.0f
+      && overlaps(desc.keepOutRect, position, radius);
+}
+
+ezUInt32 generateAsteroidField(const AsteroidFieldDesc& desc, ezDynamicArray<Asteroid>& out)
+{
+  const auto& bounds = desc.bounds;
+  const auto area = bounds.width * bounds.height;
+  if(desc.numAsteroids == 0 || area <= 0.0f)
+  {
+    return 0;
+  }
+
+  // Random sequential placement stops making progress at about 55% coverage.
+  // Aiming for half of that keeps the rejection rate low until the very last asteroid.
+  const auto targetDistance = std::sqrt(0.35f * area / desc.numAsteroids);
+  const auto overlapDistance = 2.0f * desc.radius + desc.spacing;
+
+  FieldGrid grid;
+  grid.cellSize = ezMath::Max(targetDistance, overlapDistance);
+  grid.numCellsX = ezMath::Max(1, static_cast<ezInt32>(std::ceil(bounds.width / grid.cellSize)));
+  grid.numCellsY = ezMath::Max(1, static_cast<ezInt32>(std::ceil(bounds.height / grid.cellSize)));
+  grid.cells.SetCount(grid.numCellsX * grid.numCellsY);
+  for(auto& cell : grid.cells)
+  {
+    cell = EmptyCell;
+  }
+  grid.disks.Reserve(desc.numAsteroids);
+
+  out.Reserve(out.GetCount() + desc.numAsteroids);
+
+  RandomEngine random(desc.seed);
+  const ezUInt32 maxAttemptsPerAsteroid = 64;
+  auto attemptsLeft = static_cast<ezUInt64>(desc.numAsteroids) * maxAttemptsPerAsteroid;
+
+  ezUInt32 numPlaced = 0;
+  while(numPlaced < desc.numAsteroids && attemptsLeft > 0)
+  {
+    --attemptsLeft;
+
+    Asteroid a;
+    a.lives = pickLives(desc, random);
+    a.boundingRadius = desc.radius - Asteroid::RadiusLossPerLife * (Asteroid::NumLives - a.lives);
+    a.transform.position.x = random.uniform(bounds.x, bounds.x + bounds.width);
+    a.transform.position.y = random.uniform(bounds.y, bounds.y + bounds.height);
+    const auto& pos = a.transform.position;
+
+    if(isKeptOut(desc, pos, a.boundingRadius))
+    {
+      continue;
+    }
+
+    auto cellX = cellCoord(pos.x, bounds.x, grid.cellSize, grid.numCellsX);
+    auto cellY = cellCoord(pos.y, bounds.y, grid.cellSize, grid.numCellsY);
+
+    // The cell size is at least the largest distance that counts as too close,
+    // so only the neighboring cells can contain asteroids that are.
+    bool isTooClose = false;
+    for(auto y = ezMath::Max(cellY - 1, 0); y <= ezMath::Min(cellY + 1, grid.numCellsY - 1) && !isTooClose; ++y)
+    {
+      for(auto x = ezMath::Max(cellX - 1, 0); x <= ezMath::Min(cellX + 1, grid.numCellsX - 1) && !isTooClose; ++x)
+      {
+        for(auto i = grid.cells[y * grid.numCellsX + x]; i != EmptyCell; i = grid.disks[i].next)
+        {
+          const auto& other = grid.disks[i];
+          auto minDistance = ezMath::Max(targetDistance, a.boundingRadius + other.radius + desc.spacing);
+          if((other.center - pos).GetLengthSquared() < ezMath::Square(minDistance))
+          {
+            isTooClose = true;
+            break;
+          }
+        }
+      }
+    }
+
+    if(isTooClose)
+    {
+      continue;
+    }
+
+    auto angle = ezAngle::Degree(random.uniform(0.0f, 360.0f));
+    auto speed = random.uniform(desc.minSpeed, desc.maxSpeed);
+    a.linearVelocity.Set(-ezMath::Sin(angle) * speed, ezMath::Cos(angle) * speed);
+
+    auto& cell = grid.cells[cellY * grid.numCellsX + cellX];
+    grid.disks.PushBack(PlacedDisk{ pos, a.boundingRadius, cell });
+    cell = numPlaced;
+    out.PushBack(a);
+    ++numPlaced;
+  }
+
+  return numPlaced;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <asteroids/world.h>
+
+/// \brief Describes a field of asteroids to generate.
+struct AsteroidFieldDesc
+{
+  ezRectFloat bounds; ///< Where asteroid centers are placed.
+  ezUInt32 numAsteroids = 0;
+
+  /// Bounding radius of an asteroid with all of its lives. Every life less makes it Asteroid::RadiusLossPerLife smaller.
+  float radius = 32.0f;
+
+  /// Relative frequency of asteroids with 1, 2, ... Asteroid::NumLives lives. All full-sized by default.
+  float livesWeights[Asteroid::NumLives] = { 0.0f, 0.0f, 1.0f };
+
+  float minSpeed = Asteroid::MinSpeed;
+  float maxSpeed = Asteroid::MaxSpeed;
+
+  /// Additional free space between any two asteroids.
+  float spacing = 0.0f;
+
+  /// No asteroid overlaps this circle, e.g. around the ship. Ignored if the radius is 0.
+  ezVec2 keepOutCenter = ezVec2::ZeroVector();
+  float keepOutRadius = 0.0f;
+
+  /// No asteroid overlaps this rectangle, e.g. the view. Ignored if it is empty.
+  ezRectFloat keepOutRect = ezRectFloat(0, 0, 0, 0);
+
+  ezUInt64 seed = 0;
+};
+
+/// \brief Places non-overlapping asteroids evenly spread over an area (blue noise).
+///
+/// Candidates are drawn uniformly and rejected if they come closer to an
+/// already placed asteroid than a minimum distance. That distance is derived
+/// from the area per asteroid, so the asteroids spread over all of \a desc.bounds
+/// instead of clumping, but never less than what is needed to not overlap.
+/// Placed asteroids are looked up in a uniform grid with a cell size of that
+/// distance, so every candidate only checks the 3x3 cells around it and the
+/// whole field is generated in time and memory linear in the number of asteroids.
+///
+/// The same desc always results in the same field, on every platform.
+///
+/// \return The number of asteroids added to \a out, which is less than requested
+///         if the area is too crowded to fit them all.
+ezUInt32 generateAsteroidField(const AsteroidFieldDesc& desc, ezDynamicArray<Asteroid>& out);
@@ -0,0 +1,99 @@
+#include <asteroids/benchmarks.h>
+#include <asteroids/rollback.h>
+#include <asteroids/bots.h>
+#include <asteroids/asteroidField.h>
+
+#include <cmath>
+
+void benchmarkRollback()
+{
+  EZ_LOG_BLOCK("Rollback Benchmark");
+
+  const ezUInt32 numAsteroids = 10000;
+  const ezUInt32 numResimulatedTicks = 8;
+  const ezUInt32 numRuns = 200;
+  const auto tickDuration = ezTime::Seconds(1.0 / 60.0);
+
+  // Big enough for all asteroids to be placed without overlapping.
+  SimulationDesc desc;
+  desc.viewBounds = ezRectFloat(-8192, -8192, 16384, 16384);
+  desc.worldBounds = desc.viewBounds;
+  desc.numInitialAsteroids = numAsteroids;
+  desc.seed = 42;
+
+  LevelState state;
+  initialize(state, desc);
+
+  RollbackBuffer rollback(2 * numResimulatedTicks, tickDuration);
+
+  // Fill every slot of the ring so no run has to allocate.
+  for(ezUInt32 i = 0; i < 4 * numResimulatedTicks; ++i)
+  {
+    rollback.advance(state, scriptedInput(rollback.getCurrentTick()));
+  }
+
+  ezTime total;
+  ezTime fastest = ezTime::Seconds(1000.0);
+  ezTime slowest;
+  for(ezUInt32 run = 0; run < numRuns; ++run)
+  {
+    auto tick = rollback.getCurrentTick() - numResimulatedTicks;
+    auto corrected = scriptedInput(tick);
+    corrected.shoot = !corrected.shoot;
+
+    LevelStepResult result;
+    auto start = ezTime::Now();
+    rollback.correctInput(tick, corrected, state, result);
+    auto duration = ezTime::Now() - start;
+
+    total += duration;
+    fastest = ezMath::Min(fastest, duration);
+    slowest = ezMath::Max(slowest, duration);
+
+    rollback.advance(state, scriptedInput(rollback.getCurrentTick()));
+  }
+
+  ezLog::Info("Re-simulating %u ticks with %u asteroids (%u runs):", numResimulatedTicks, numAsteroids, numRuns);
+  ezLog::Info("  min %.3f ms, avg %.3f ms, max %.3f ms, frame budget %.3f ms",
+              fastest.GetMilliseconds(),
+              (total / numRuns).GetMilliseconds(),
+              slowest.GetMilliseconds(),
+              tickDuration.GetMilliseconds());
+}
+
+void benchmarkAsteroidField()
+{
+  EZ_LOG_BLOCK("Asteroid Field Benchmark");
+
+  const ezUInt32 numRuns = 5;
+
+  AsteroidFieldDesc desc;
+  desc.numAsteroids = 1000 * 1000;
+  desc.livesWeights[0] = 1.0f;
+  desc.livesWeights[1] = 2.0f;
+  desc.livesWeights[2] = 4.0f;
+  desc.seed = 42;
+
+  // About 16 times the area the asteroids cover.
+  const auto extent = 4.0f * desc.radius * std::sqrt(static_cast<float>(desc.numAsteroids));
+  desc.bounds = ezRectFloat(-0.5f * extent, -0.5f * extent, extent, extent);
+
+  ezDynamicArray<Asteroid> asteroids;
+  ezTime fastest = ezTime::Seconds(1000.0);
+  ezUInt32 numPlaced = 0;
+  for(ezUInt32 run = 0; run < numRuns; ++run)
+  {
+    asteroids.Clear();
+
+    auto start = ezTime::Now();
+    numPlaced = generateAsteroidField(desc, asteroids);
+    fastest = ezMath::Min(fastest, ezTime::Now() - start);
+  }
+
+  ezLog::Info("Placed %u of %u asteroids in %.1f ms (%.1f ns per asteroid, best of %u runs).",
+              numPlaced,
+              desc.numAsteroids,
+              fastest.GetMilliseconds(),
+              fastest.GetMicroseconds() * 1000.0 / ezMath::Max(numPlaced, 1u),
+              numRuns);
+}
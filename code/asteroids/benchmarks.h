@@ -0,0 +1,7 @@
+#pragma once
+
+/// \brief Measures re-simulating 8 ticks of a level with 10000 asteroids, as done for a rollback.
+void benchmarkRollback();
+
+/// \brief Measures generating a field of 1 million asteroids.
+void benchmarkAsteroidField();
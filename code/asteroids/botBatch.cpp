@@ -0,0 +1,255 @@
+#include <asteroids/botBatch.h>
+
+#include <Foundation/IO/FileSystem/FileWriter.h>
+
+#include <atomic>
+#include <thread>
+
+Tuning defaultTuning()
+{
+  Ship ship;
+  SimulationDesc desc;
+
+  Tuning tuning;
+  tuning.speedIncRate = ship.speedIncRate;
+  tuning.linearDamping = ship.linearDamping;
+  tuning.minAsteroidSpeed = desc.minAsteroidSpeed;
+  tuning.maxAsteroidSpeed = desc.maxAsteroidSpeed;
+  tuning.numInitialAsteroids = desc.numInitialAsteroids;
+  return tuning;
+}
+
+static void playGame(const BotBatchDesc& desc, ezUInt32 gameIndex, LevelState& state, BotGameOutcome& outcome)
+{
+  outcome = BotGameOutcome();
+  outcome.tuning = gameIndex / desc.gamesPerTuning;
+  const auto& tuning = desc.tunings[outcome.tuning];
+
+  SimulationDesc simDesc;
+  simDesc.viewBounds = desc.bounds;
+  simDesc.worldBounds = desc.bounds;
+  simDesc.numInitialAsteroids = tuning.numInitialAsteroids;
+  simDesc.minAsteroidSpeed = tuning.minAsteroidSpeed;
+  simDesc.maxAsteroidSpeed = tuning.maxAsteroidSpeed;
+  simDesc.seed = desc.seed + gameIndex % desc.gamesPerTuning;
+  initialize(state, simDesc);
+
+  state.ship.speedIncRate = tuning.speedIncRate;
+  state.ship.linearDamping = tuning.linearDamping;
+
+  const auto maxTicks = static_cast<ezUInt64>(desc.maxGameTime.GetSeconds() / desc.tickDuration.GetSeconds());
+  const auto start = ezTime::Now();
+
+  ezUInt64 tick = 0;
+  while(tick < maxTicks)
+  {
+    auto result = step(state, botInput(desc.pilot, state, tick), desc.tickDuration);
+    if(result.allAsteroidsDestroyed)
+    {
+      outcome.cleared = true;
+      break;
+    }
+
+    ++tick;
+    outcome.numKills += result.numAsteroidsDestroyed;
+
+    if(result.shipDestroyed)
+    {
+      outcome.shipDestroyed = true;
+      break;
+    }
+  }
+
+  outcome.wallTime = ezTime::Now() - start;
+  outcome.numTicks = tick;
+  outcome.survivalTime = ezTime::Seconds(tick * desc.tickDuration.GetSeconds());
+}
+
+ezResult runBotBatch(const BotBatchDesc& desc, ezDynamicArray<BotGameOutcome>& outcomes)
+{
+  const auto numGames64 = static_cast<ezUInt64>(desc.tunings.GetCount()) * desc.gamesPerTuning;
+  if(numGames64 > 0xFFFFFFFFull)
+  {
+    ezLog::Error("Too many bot games: %u tunings with %u games each.", desc.tunings.GetCount(), desc.gamesPerTuning);
+    outcomes.Clear();
+    return EZ_FAILURE;
+  }
+
+  const auto numGames = static_cast<ezUInt32>(numGames64);
+  outcomes.SetCount(numGames);
+  if(numGames == 0)
+  {
+    return EZ_SUCCESS;
+  }
+
+  auto numThreads = desc.numThreads;
+  if(numThreads == 0)
+  {
+    numThreads = ezMath::Max(1u, std::thread::hardware_concurrency());
+  }
+  numThreads = ezMath::Min(numThreads, numGames);
+
+  std::atomic<ezUInt32> nextGame(0);
+  auto work = [&desc, &outcomes, &nextGame, numGames]()
+  {
+    // Reused for all games of this thread, so its memory is only allocated once.
+    LevelState state;
+    for(auto game = nextGame++; game < numGames; game = nextGame++)
+    {
+      playGame(desc, game, state, outcomes[game]);
+    }
+  };
+
+  ezDynamicArray<std::thread> threads;
+  for(ezUInt32 i = 1; i < numThreads; ++i)
+  {
+    threads.ExpandAndGetRef() = std::thread(work);
+  }
+
+  // The calling thread pulls its weight too.
+  work();
+
+  for(auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult writeBotBatchCsv(const BotBatchDesc& desc, const ezDynamicArray<BotGameOutcome>& outcomes, ezStreamWriterBase& writer)
+{
+  ezStringBuilder line;
+  line.Format("pilot,speedIncRate,linearDamping,minAsteroidSpeed,maxAsteroidSpeed,numInitialAsteroids,"
+              "games,destroyed,cleared,timedOut,"
+              "avgSurvivalSeconds,minSurvivalSeconds,maxSurvivalSeconds,avgKills,ticks,ticksPerSecond\n");
+  if(writer.WriteBytes(line.GetData(), line.GetElementCount()).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  for(ezUInt32 t = 0; t < desc.tunings.GetCount(); ++t)
+  {
+    const auto& tuning = desc.tunings[t];
+
+    ezUInt32 numGames = 0;
+    ezUInt32 numDestroyed = 0;
+    ezUInt32 numCleared = 0;
+    ezUInt64 numTicks = 0;
+    ezUInt64 numKills = 0;
+    double totalSurvival = 0.0;
+    double minSurvival = 0.0;
+    double maxSurvival = 0.0;
+    double totalWallTime = 0.0;
+
+    for(const auto& outcome : outcomes)
+    {
+      if(outcome.tuning != t)
+      {
+        continue;
+      }
+
+      auto survival = outcome.survivalTime.GetSeconds();
+      minSurvival = numGames == 0 ? survival : ezMath::Min(minSurvival, survival);
+      maxSurvival = numGames == 0 ? survival : ezMath::Max(maxSurvival, survival);
+      totalSurvival += survival;
+      totalWallTime += outcome.wallTime.GetSeconds();
+      numTicks += outcome.numTicks;
+      numKills += outcome.numKills;
+      if(outcome.shipDestroyed) ++numDestroyed;
+      if(outcome.cleared) ++numCleared;
+      ++numGames;
+    }
+
+    const auto gamesDivisor = static_cast<double>(ezMath::Max(numGames, 1u));
+    line.Format("%s,%.2f,%.3f,%.2f,%.2f,%u,%u,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%llu,%.0f\n",
+                toString(desc.pilot),
+                tuning.speedIncRate,
+                tuning.linearDamping,
+                tuning.minAsteroidSpeed,
+                tuning.maxAsteroidSpeed,
+                tuning.numInitialAsteroids,
+                numGames,
+                numDestroyed,
+                numCleared,
+                numGames - numDestroyed - numCleared,
+                totalSurvival / gamesDivisor,
+                minSurvival,
+                maxSurvival,
+                numKills / gamesDivisor,
+                static_cast<unsigned long long>(numTicks),
+                totalWallTime > 0.0 ? numTicks / totalWallTime : 0.0);
+    if(writer.WriteBytes(line.GetData(), line.GetElementCount()).Failed())
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult runTuningSweep(BotBatchDesc desc, const char* csvPath)
+{
+  EZ_LOG_BLOCK("Bot Batch");
+
+  if(desc.tunings.IsEmpty())
+  {
+    const auto base = defaultTuning();
+    const float speedIncRateScales[] = { 0.66f, 1.0f, 1.33f };
+    const float linearDampingScales[] = { 0.5f, 1.0f, 2.0f };
+    const float asteroidSpeedScales[] = { 1.0f, 1.5f };
+    const ezUInt32 asteroidCounts[] = { base.numInitialAsteroids, 2 * base.numInitialAsteroids };
+
+    for(auto speedIncRateScale : speedIncRateScales)
+    {
+      for(auto linearDampingScale : linearDampingScales)
+      {
+        for(auto asteroidSpeedScale : asteroidSpeedScales)
+        {
+          for(auto asteroidCount : asteroidCounts)
+          {
+            auto& tuning = desc.tunings.ExpandAndGetRef();
+            tuning = base;
+            tuning.speedIncRate *= speedIncRateScale;
+            tuning.linearDamping *= linearDampingScale;
+            tuning.minAsteroidSpeed *= asteroidSpeedScale;
+            tuning.maxAsteroidSpeed *= asteroidSpeedScale;
+            tuning.numInitialAsteroids = asteroidCount;
+          }
+        }
+      }
+    }
+  }
+
+  ezLog::Info("Playing %u games with the %s pilot for each of %u tunings.",
+              desc.gamesPerTuning, toString(desc.pilot), desc.tunings.GetCount());
+
+  ezDynamicArray<BotGameOutcome> outcomes;
+  const auto start = ezTime::Now();
+  if(runBotBatch(desc, outcomes).Failed())
+  {
+    return EZ_FAILURE;
+  }
+  const auto duration = ezTime::Now() - start;
+
+  ezUInt64 numTicks = 0;
+  for(const auto& outcome : outcomes)
+  {
+    numTicks += outcome.numTicks;
+  }
+  ezLog::Info("Simulated %llu ticks of %u games in %.2f s (%.0f ticks/s).",
+              static_cast<unsigned long long>(numTicks),
+              outcomes.GetCount(),
+              duration.GetSeconds(),
+              numTicks / ezMath::Max(duration.GetSeconds(), 0.001));
+
+  ezFileWriter file;
+  if(file.Open(csvPath).Failed() || writeBotBatchCsv(desc, outcomes, file).Failed())
+  {
+    ezLog::Error("Failed to write bot batch statistics to '%s'.", csvPath);
+    return EZ_FAILURE;
+  }
+
+  ezLog::Success("Wrote bot batch statistics to '%s'.", csvPath);
+  return EZ_SUCCESS;
+}
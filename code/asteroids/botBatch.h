@@ -0,0 +1,62 @@
+#pragma once
+
+#include <asteroids/bots.h>
+
+#include <Foundation/IO/Stream.h>
+
+/// \brief The values that are tuned by hand-playing otherwise.
+struct Tuning
+{
+  float speedIncRate;
+  float linearDamping;
+  float minAsteroidSpeed;
+  float maxAsteroidSpeed;
+  ezUInt32 numInitialAsteroids;
+};
+
+/// \brief The tuning the game is played with.
+Tuning defaultTuning();
+
+/// \brief Many headless games, played by bots, for a number of tunings.
+struct BotBatchDesc
+{
+  static const ezUInt32 MaxGamesPerTuning = 1000000;
+  static const ezUInt32 MaxThreads = 1024;
+
+  ezDynamicArray<Tuning> tunings;
+  ezUInt32 gamesPerTuning = 64;
+  ezUInt32 numThreads = 0; ///< 0 means one per hardware thread.
+  BotPilot pilot = BotPilot::Hunter;
+  ezRectFloat bounds = ezRectFloat(-256, -256, 512, 512);
+  ezTime tickDuration = ezTime::Seconds(1.0 / 60.0);
+  ezTime maxGameTime = ezTime::Seconds(300.0); ///< Games running longer are stopped and count as timed out.
+
+  /// Game i of every tuning uses the seed `seed + i`, so all tunings are played on the same levels.
+  ezUInt64 seed = 0;
+};
+
+struct BotGameOutcome
+{
+  ezUInt32 tuning = 0; ///< Index into BotBatchDesc::tunings.
+  ezUInt64 numTicks = 0;
+  ezUInt32 numKills = 0; ///< Asteroids the bullet took the last life of.
+  ezTime survivalTime; ///< Simulated time until the game ended.
+  ezTime wallTime;     ///< Real time it took to simulate the game.
+  bool shipDestroyed = false;
+  bool cleared = false;
+};
+
+/// \brief Plays all games of \a desc in parallel and stores one outcome per game in \a outcomes.
+///
+/// Games are handed out to the worker threads one at a time, so the threads stay
+/// busy until the very end, no matter how long the individual games take.
+/// Fails without playing anything if there are more games than fit into \a outcomes.
+ezResult runBotBatch(const BotBatchDesc& desc, ezDynamicArray<BotGameOutcome>& outcomes);
+
+/// \brief Writes one CSV line of aggregated statistics per tuning.
+ezResult writeBotBatchCsv(const BotBatchDesc& desc, const ezDynamicArray<BotGameOutcome>& outcomes, ezStreamWriterBase& writer);
+
+/// \brief Runs \a desc and writes the statistics to \a csvPath.
+///
+/// If \a desc has no tunings, a grid around defaultTuning() is used.
+ezResult runTuningSweep(BotBatchDesc desc, const char* csvPath);
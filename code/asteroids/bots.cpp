@@ -0,0 +1,99 @@
+#include <asteroids/bots.h>
+
+#include <cstring>
+
+LevelInput scriptedInput(ezUInt64 tick)
+{
+  LevelInput input;
+  input.thrust = (tick / 30) % 2 == 0 ? 1.0f : 0.0f;
+  input.turn = (tick / 45) % 3 == 0 ? 1.0f : -0.5f;
+  input.shoot = tick % 7 == 0;
+  return input;
+}
+
+LevelInput hunterInput(const LevelState& state)
+{
+  const auto& ship = state.ship;
+
+  const Asteroid* target = nullptr;
+  auto targetDistanceSquared = 0.0f;
+  for(auto chunkIndex : state.world.activeChunks)
+  {
+    for(const auto& a : state.world.chunks[chunkIndex].asteroids)
+    {
+      if(!a.isAlive())
+      {
+        continue;
+      }
+
+      auto distanceSquared = (a.transform.position - ship.transform.position).GetLengthSquared();
+      if(target == nullptr || distanceSquared < targetDistanceSquared)
+      {
+        target = &a;
+        targetDistanceSquared = distanceSquared;
+      }
+    }
+  }
+
+  LevelInput input;
+  if(target == nullptr)
+  {
+    input.turn = 1.0f;
+    return input;
+  }
+
+  const auto shipDir = ezVec2(-ezMath::Sin(ship.transform.rotation), ezMath::Cos(ship.transform.rotation));
+  const auto toTarget = target->transform.position - ship.transform.position;
+  const auto cross = shipDir.x * toTarget.y - shipDir.y * toTarget.x;
+  const auto aimError = ezMath::ATan2(cross, shipDir.Dot(toTarget));
+
+  // Positive turn is counter-clockwise, which is where a positive cross product points to.
+  input.turn = cross > 0.0f ? 1.0f : -1.0f;
+  input.shoot = ezMath::Abs(aimError.GetDegree()) < 10.0f;
+
+  // Close in on far away targets, but let the damping slow the ship down near them.
+  const auto safeDistance = 4.0f * (ship.boundingRadius + target->boundingRadius);
+  if(targetDistanceSquared > ezMath::Square(safeDistance) && ezMath::Abs(aimError.GetDegree()) < 45.0f)
+  {
+    input.thrust = 1.0f;
+  }
+
+  return input;
+}
+
+LevelInput botInput(BotPilot pilot, const LevelState& state, ezUInt64 tick)
+{
+  switch(pilot)
+  {
+  case BotPilot::Scripted: return scriptedInput(tick);
+  case BotPilot::Hunter:   return hunterInput(state);
+  }
+
+  return LevelInput();
+}
+
+const char* toString(BotPilot pilot)
+{
+  switch(pilot)
+  {
+  case BotPilot::Scripted: return "scripted";
+  case BotPilot::Hunter:   return "hunter";
+  }
+
+  return "unknown";
+}
+
+ezResult fromString(const char* name, BotPilot& pilot)
+{
+  const BotPilot pilots[] = { BotPilot::Scripted, BotPilot::Hunter };
+  for(auto candidate : pilots)
+  {
+    if(std::strcmp(name, toString(candidate)) == 0)
+    {
+      pilot = candidate;
+      return EZ_SUCCESS;
+    }
+  }
+
+  return EZ_FAILURE;
+}
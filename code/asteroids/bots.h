@@ -0,0 +1,26 @@
+#pragma once
+
+#include <asteroids/simulation.h>
+
+/// \file
+/// Pilots that play the game without a human, by producing the LevelInput for every tick.
+
+enum class BotPilot
+{
+  Scripted, ///< Follows a fixed pattern that does not look at the level at all.
+  Hunter,   ///< Turns towards the closest asteroid and shoots once it is lined up.
+};
+
+/// \brief A fixed, repeating pattern of thrusting, turning and shooting.
+LevelInput scriptedInput(ezUInt64 tick);
+
+/// \brief Aims at the closest live asteroid in an active chunk and keeps its distance.
+LevelInput hunterInput(const LevelState& state);
+
+LevelInput botInput(BotPilot pilot, const LevelState& state, ezUInt64 tick);
+
+const char* toString(BotPilot pilot);
+
+/// \brief The pilot toString() returns \a name for.
+/// \return EZ_FAILURE if there is no such pilot; \a pilot is left untouched then.
+ezResult fromString(const char* name, BotPilot& pilot);
@@ -0,0 +1,26 @@
+#include <asteroids/fileUtils.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+
+ezResult readWholeFile(const char* path, ezDynamicArray<ezUInt8>& out_bytes)
+{
+  out_bytes.Clear();
+
+  ezFileReader file;
+  if(file.Open(path).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 readSize = 64 * 1024;
+  ezUInt64 numRead = 0;
+  do
+  {
+    auto offset = out_bytes.GetCount();
+    out_bytes.SetCount(offset + readSize);
+    numRead = file.ReadBytes(&out_bytes[offset], readSize);
+    out_bytes.SetCount(offset + static_cast<ezUInt32>(numRead));
+  } while(numRead == readSize);
+
+  return EZ_SUCCESS;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+
+/// \brief Reads the whole file at \a path into \a out_bytes.
+ezResult readWholeFile(const char* path, ezDynamicArray<ezUInt8>& out_bytes);
@@ -0,0 +1,203 @@
+#include <asteroids/framePacer.h>
+
+#include <chrono>
+#include <thread>
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
+  #include <Foundation/Basics/Platform/Win/IncludeWindows.h>
+  #include <mmsystem.h>
+#endif
+
+void initialize(TimeHistogram& histogram, ezTime bucketWidth, ezUInt32 numBuckets)
+{
+  EZ_ASSERT_DEV(numBuckets > 0, "A histogram needs at least one bucket.");
+
+  histogram.bucketWidth = bucketWidth;
+  histogram.buckets.SetCount(numBuckets);
+  for(auto& bucket : histogram.buckets)
+  {
+    bucket = 0;
+  }
+  histogram.count = 0;
+  histogram.total = ezTime();
+  histogram.min = ezTime();
+  histogram.max = ezTime();
+}
+
+void add(TimeHistogram& histogram, ezTime duration)
+{
+  auto index = static_cast<ezUInt32>(ezMath::Max(duration.GetSeconds(), 0.0) / histogram.bucketWidth.GetSeconds());
+  index = ezMath::Min(index, histogram.buckets.GetCount() - 1);
+  ++histogram.buckets[index];
+
+  histogram.min = histogram.count == 0 ? duration : ezMath::Min(histogram.min, duration);
+  histogram.max = histogram.count == 0 ? duration : ezMath::Max(histogram.max, duration);
+  histogram.total += duration;
+  ++histogram.count;
+}
+
+ezTime quantile(const TimeHistogram& histogram, double fraction)
+{
+  auto threshold = static_cast<ezUInt64>(fraction * histogram.count);
+  ezUInt64 count = 0;
+  for(ezUInt32 i = 0; i < histogram.buckets.GetCount(); ++i)
+  {
+    count += histogram.buckets[i];
+    if(count > threshold)
+    {
+      return ezTime::Seconds((i + 1) * histogram.bucketWidth.GetSeconds());
+    }
+  }
+
+  return histogram.max;
+}
+
+// FramePacer
+// ==========
+
+FramePacer::FramePacer()
+{
+  const auto bucketWidth = ezTime::Microseconds(250);
+  const ezUInt32 numBuckets = 400; // Up to 100 ms.
+  initialize(this->frameTimes, bucketWidth, numBuckets);
+  initialize(this->latencies, bucketWidth, numBuckets);
+
+  this->sleepSlack = ezTime::Milliseconds(2);
+  this->setTargetFrameRate(60.0);
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
+  timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
+  timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::setTargetFrameRate(double framesPerSecond)
+{
+  this->targetFrameTime = framesPerSecond > 0.0 ? ezTime::Seconds(1.0 / framesPerSecond) : ezTime();
+}
+
+ezTime FramePacer::beginFrame()
+{
+  const auto isPaced = this->targetFrameTime.GetSeconds() > 0.0;
+  if(isPaced && !this->isFirstFrame)
+  {
+    this->waitUntil(this->nextFrame);
+  }
+
+  const auto now = ezTime::Now();
+  auto dt = ezTime();
+  if(!this->isFirstFrame)
+  {
+    dt = now - this->frameStart;
+    add(this->frameTimes, dt);
+  }
+
+  this->nextFrame += this->targetFrameTime;
+  if(this->isFirstFrame || this->nextFrame < now)
+  {
+    this->nextFrame = now + this->targetFrameTime;
+  }
+
+  this->frameStart = now;
+  this->isFirstFrame = false;
+  return dt;
+}
+
+void FramePacer::endFrame()
+{
+  add(this->latencies, ezTime::Now() - this->frameStart);
+}
+
+void FramePacer::waitUntil(ezTime deadline)
+{
+  // The slack may grow up to a whole frame, so even a coarse OS timer does not make frames late.
+  const auto minSlack = ezTime::Microseconds(500);
+  const auto maxSlack = ezMath::Max(this->targetFrameTime, minSlack);
+
+  auto remaining = deadline - ezTime::Now();
+  if(remaining > this->sleepSlack)
+  {
+    auto requested = remaining - this->sleepSlack;
+    auto before = ezTime::Now();
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(requested.GetMicroseconds())));
+    auto overslept = (ezTime::Now() - before) - requested;
+
+    // Back off right away when the OS oversleeps more than expected, creep closer slowly otherwise.
+    auto slack = overslept > this->sleepSlack
+      ? overslept
+      : ezTime::Seconds(0.95 * this->sleepSlack.GetSeconds() + 0.05 * overslept.GetSeconds());
+    this->sleepSlack = ezMath::Clamp(slack, minSlack, maxSlack);
+  }
+
+  while(ezTime::Now() < deadline)
+  {
+    std::this_thread::yield();
+  }
+}
+
+static void logSummary(const char* name, const TimeHistogram& histogram)
+{
+  if(histogram.count == 0)
+  {
+    return;
+  }
+
+  ezLog::Info("%s: avg %.2f ms, median %.2f ms, 99%% %.2f ms, max %.2f ms (%llu samples)",
+              name,
+              histogram.total.GetMilliseconds() / histogram.count,
+              quantile(histogram, 0.5).GetMilliseconds(),
+              quantile(histogram, 0.99).GetMilliseconds(),
+              histogram.max.GetMilliseconds(),
+              static_cast<unsigned long long>(histogram.count));
+}
+
+void FramePacer::logSummary() const
+{
+  EZ_LOG_BLOCK("Frame Pacing");
+
+  if(this->targetFrameTime.GetSeconds() > 0.0)
+  {
+    ezLog::Info("Target: %.2f ms per frame", this->targetFrameTime.GetMilliseconds());
+  }
+  else
+  {
+    ezLog::Info("Target: uncapped");
+  }
+  ::logSummary("Frame time", this->frameTimes);
+  ::logSummary("Input to present", this->latencies);
+}
+
+ezResult FramePacer::writeHistograms(ezStreamWriterBase& writer) const
+{
+  ezStringBuilder line;
+  line.Format("bucketStartMs,bucketEndMs,frames,latencies\n");
+  if(writer.WriteBytes(line.GetData(), line.GetElementCount()).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  const auto bucketWidth = this->frameTimes.bucketWidth.GetMilliseconds();
+  for(ezUInt32 i = 0; i < this->frameTimes.buckets.GetCount(); ++i)
+  {
+    auto numFrames = this->frameTimes.buckets[i];
+    auto numLatencies = this->latencies.buckets[i];
+    if(numFrames == 0 && numLatencies == 0)
+    {
+      continue;
+    }
+
+    line.Format("%.2f,%.2f,%u,%u\n", i * bucketWidth, (i + 1) * bucketWidth, numFrames, numLatencies);
+    if(writer.WriteBytes(line.GetData(), line.GetElementCount()).Failed())
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
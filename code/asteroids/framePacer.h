@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Foundation/Time/Time.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/Stream.h>
+
+/// \brief Counts durations in buckets of equal width.
+struct TimeHistogram
+{
+  ezTime bucketWidth;
+  ezDynamicArray<ezUInt32> buckets; ///< The last bucket also counts everything beyond it.
+  ezUInt64 count = 0;
+  ezTime total;
+  ezTime min;
+  ezTime max;
+};
+
+void initialize(TimeHistogram& histogram, ezTime bucketWidth, ezUInt32 numBuckets);
+
+void add(TimeHistogram& histogram, ezTime duration);
+
+/// \brief Upper end of the bucket below which \a fraction of all durations lie.
+ezTime quantile(const TimeHistogram& histogram, double fraction);
+
+/// \brief Keeps the game loop at a target frame rate without burning a core while waiting.
+///
+/// Waiting is done in two phases: the thread sleeps until shortly before the
+/// frame is due and spins for the rest. How long before is learned from how
+/// much the OS actually oversleeps, so the spinning stays short on systems
+/// with precise timers and the frame starts on time on systems without.
+/// On Windows, the system timer resolution is raised to 1 ms while a pacer exists,
+/// since the default of about 15.6 ms would leave little to sleep.
+///
+/// Frames are scheduled at fixed intervals, so a slightly late frame is
+/// followed by a slightly shorter one. Frames that are more than a whole frame
+/// late are not made up for; the schedule starts over from the late frame instead.
+class FramePacer
+{
+public:
+  FramePacer();
+  ~FramePacer();
+  FramePacer(const FramePacer&) = delete;
+  FramePacer& operator=(const FramePacer&) = delete;
+
+  /// \brief A rate of 0 runs uncapped, e.g. for benchmarks.
+  void setTargetFrameRate(double framesPerSecond);
+
+  /// \brief Waits until the next frame is due and returns the time since the previous one started.
+  ///
+  /// Input should be read right after this, since the time from here to
+  /// endFrame() is recorded as input-to-present latency.
+  ezTime beginFrame();
+
+  /// \brief Call right after the frame was presented.
+  void endFrame();
+
+  const TimeHistogram& getFrameTimes() const { return this->frameTimes; }
+  const TimeHistogram& getLatencies() const { return this->latencies; }
+
+  /// \brief Logs average, median, 99th percentile and maximum of frame time and latency.
+  void logSummary() const;
+
+  /// \brief Writes both histograms as CSV, one line per bucket.
+  ezResult writeHistograms(ezStreamWriterBase& writer) const;
+
+private:
+  void waitUntil(ezTime deadline);
+
+  ezTime targetFrameTime;
+  ezTime sleepSlack; ///< How long before a deadline sleeping stops and spinning starts.
+  ezTime nextFrame;
+  ezTime frameStart;
+  bool isFirstFrame = true;
+
+  TimeHistogram frameTimes;
+  TimeHistogram latencies;
+};
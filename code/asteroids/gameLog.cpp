@@ -0,0 +1,151 @@
+#include <asteroids/gameLog.h>
+
+#include <chrono>
+
+enum { MaxBatchSize = 256 };
+
+GameLog::GameLog(ezUInt32 capacity) : queue(capacity)
+{
+}
+
+GameLog::~GameLog()
+{
+  this->stop();
+}
+
+ezResult GameLog::start(const char* path, bool echoToLog)
+{
+  EZ_ASSERT_DEV(!this->isRunning, "The game log is already running.");
+
+  if(this->file.Open(path).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  this->echoToLog = echoToLog;
+  this->isRunning = true;
+  this->writer = std::thread(&GameLog::run, this);
+  return EZ_SUCCESS;
+}
+
+void GameLog::stop()
+{
+  if(!this->writer.joinable())
+  {
+    return;
+  }
+
+  this->isRunning = false;
+  this->writer.join();
+  this->file.Close();
+}
+
+void GameLog::log(GameLogRecord::Type type, ezInt32 value, ezTime gameTime)
+{
+  GameLogRecord record;
+  record.type = type;
+  record.value = value;
+  record.gameTime = gameTime.GetSeconds();
+
+  if(!this->queue.tryPush(record))
+  {
+    this->numDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void GameLog::run()
+{
+  // Backing off costs no records, stop() still lets the loop below drain the queue.
+  const auto minIdleWait = std::chrono::milliseconds(2);
+  const auto maxIdleWait = std::chrono::milliseconds(64);
+
+  auto idleWait = minIdleWait;
+  while(this->isRunning)
+  {
+    if(this->writeBatch())
+    {
+      idleWait = minIdleWait;
+    }
+    else
+    {
+      std::this_thread::sleep_for(idleWait);
+      idleWait = ezMath::Min(2 * idleWait, maxIdleWait);
+    }
+  }
+
+  // Whatever was logged before stop() was called.
+  while(this->writeBatch())
+  {
+  }
+}
+
+static ezUInt32 describe(const GameLogRecord& record, ezStringBuilder (&messages)[2])
+{
+  switch(record.type)
+  {
+  case GameLogRecord::ShipHit:
+    messages[0] = "You ship was hit!";
+    messages[1].Format("Remaining lives: %d", record.value);
+    return 2;
+  case GameLogRecord::ShipDestroyed:
+    messages[0] = "Your ship was destroyed.";
+    messages[1] = "Game Over";
+    return 2;
+  case GameLogRecord::AllAsteroidsDestroyed:
+    messages[0] = "You destroyed all asteroids!";
+    messages[1] = "Game Over";
+    return 2;
+  }
+
+  messages[0].Format("Unknown gameplay event %u.", record.type);
+  return 1;
+}
+
+bool GameLog::writeBatch()
+{
+  this->text.Clear();
+
+  ezUInt32 numRecords = 0;
+  GameLogRecord record;
+  ezStringBuilder messages[2];
+  while(numRecords < MaxBatchSize && this->queue.tryPop(record))
+  {
+    ++numRecords;
+
+    auto numMessages = describe(record, messages);
+    for(ezUInt32 i = 0; i < numMessages; ++i)
+    {
+      this->text.AppendFormat("[%10.3f] %s\n", record.gameTime, messages[i].GetData());
+
+      if(!this->echoToLog)
+      {
+        continue;
+      }
+
+      if(record.type == GameLogRecord::AllAsteroidsDestroyed)
+      {
+        ezLog::Success("%s", messages[i].GetData());
+      }
+      else
+      {
+        ezLog::Info("%s", messages[i].GetData());
+      }
+    }
+  }
+
+  auto numDropped = this->getNumDropped();
+  if(numDropped != this->numDroppedWritten)
+  {
+    this->text.AppendFormat("[dropped %llu messages]\n", static_cast<unsigned long long>(numDropped - this->numDroppedWritten));
+    this->numDroppedWritten = numDropped;
+  }
+
+  if(this->text.IsEmpty())
+  {
+    return false;
+  }
+
+  this->file.WriteBytes(this->text.GetData(), this->text.GetElementCount());
+  this->file.Flush();
+  return true;
+}
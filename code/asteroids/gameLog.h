@@ -0,0 +1,70 @@
+#pragma once
+
+#include <asteroids/mpscQueue.h>
+
+#include <Foundation/Time/Time.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Strings/StringBuilder.h>
+
+#include <thread>
+
+/// \brief A gameplay event as it is queued. It is only turned into text on the writer thread.
+struct GameLogRecord
+{
+  enum Type : ezUInt32
+  {
+    ShipHit,               ///< value: Remaining lives.
+    ShipDestroyed,
+    AllAsteroidsDestroyed,
+  };
+
+  Type type;
+  ezInt32 value;
+  double gameTime; ///< Seconds of simulated time.
+};
+
+/// \brief Gameplay log that never blocks the threads reporting to it.
+///
+/// log() only copies a small fixed-size record into a lock-free queue. A
+/// background thread takes the records out in batches, formats them and
+/// appends each batch to the file with a single write. When the queue is full,
+/// records are dropped and counted instead of waiting; the writer notes how
+/// many were lost in the file.
+///
+/// Gameplay events are rare, so the writer polls less and less often while
+/// the queue stays empty, down to about 15 times per second.
+class GameLog
+{
+public:
+  explicit GameLog(ezUInt32 capacity = 4096);
+  ~GameLog();
+
+  /// \brief Opens \a path and starts the writer thread.
+  /// \param echoToLog Also pass the formatted messages on to ezLog, from the writer thread.
+  ezResult start(const char* path, bool echoToLog);
+
+  /// \brief Writes out everything that is still queued and stops the writer thread.
+  void stop();
+
+  /// \brief Can be called from any thread. Never blocks, allocates or formats.
+  void log(GameLogRecord::Type type, ezInt32 value, ezTime gameTime);
+
+  ezUInt64 getNumDropped() const { return this->numDropped.load(std::memory_order_relaxed); }
+
+private:
+  void run();
+
+  /// \return \c false if there was nothing to write.
+  bool writeBatch();
+
+  MpscQueue<GameLogRecord> queue;
+  std::atomic<ezUInt64> numDropped{ 0 };
+  std::atomic<bool> isRunning{ false };
+  std::thread writer;
+
+  // Only used by the writer thread while it is running.
+  ezFileWriter file;
+  ezStringBuilder text;
+  ezUInt64 numDroppedWritten = 0;
+  bool echoToLog = false;
+};
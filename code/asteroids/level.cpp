@@ -1,7 +1,13 @@
 #include <asteroids/level.h>
+#include <asteroids/simulation.h>
+#include <asteroids/snapshot.h>
+#include <asteroids/shaderCache.h>
+#include <asteroids/gameLog.h>
+#include <asteroids/fileUtils.h>
 
 #include <krEngine/rendering/extraction.h>
 #include <Core/Input/InputManager.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 
 #include <cstdlib>
 #include <ctime>
@@ -22,85 +28,6 @@ static ezDynamicArray<Owned<ShaderProgram>> g_shaders;
 #else
   static const unsigned int g_randomSeed = std::random_device()();
 #endif
-static auto g_randomEngine = std::default_random_engine(g_randomSeed);
-
-namespace
-{
-  struct SpacialData
-  {
-    Transform2D* transform;
-    ezVec2* linearVelocity;
-    float* boundingRadius;
-  };
-
-  struct Ship
-  {
-    enum { NumLives = 3 };
-
-    Sprite hull;
-    Sprite thruster;
-
-    Transform2D transform = Transform2D::zero();
-    ezVec2 linearVelocity = ezVec2::ZeroVector();
-    float boundingRadius = 0.0f;
-    const float speedIncRate = 300.0f; ///< Meters per second per second.
-    const float maxSpeed = 300.0f;
-    const float linearDamping = 0.9f; ///< Percentual reduction per frame.
-    const ezAngle turnSpeed = ezAngle::Degree(360.0f);
-    int lives = NumLives;
-    ezTime invulnerableTime;
-
-    bool isInvulnerable() const { return this->invulnerableTime > ezTime::Seconds(0); }
-  };
-
-  struct Asteroid
-  {
-    enum { NumLives = 3, MinSpeed = 30, MaxSpeed = 200 };
-
-    Sprite body;
-
-    Transform2D transform = Transform2D::zero();
-    ezVec2 linearVelocity = ezVec2::ZeroVector();
-    float boundingRadius = 0.0f;
-
-    int lives = NumLives;
-
-    bool isAlive() const { return this->lives > 0; }
-    bool operator ==(const Asteroid& rhs) const { return this == &rhs; }
-  };
-
-  struct Bullet
-  {
-    Sprite body;
-
-    Transform2D transform = Transform2D::zero();
-    ezVec2 linearVelocity = ezVec2::ZeroVector();
-    float boundingRadius = 0.0f;
-
-    const float speed = 500.0f; // Meters per second.
-    const ezTime maxLifeTime = ezTime::Seconds(1);
-    ezTime lifeTime;
-
-    bool isAlive() const { return this->lifeTime > ezTime(); }
-  };
-}
-
-static void move(Transform2D& transform, const ezVec2& delta)
-{
-  transform.position += delta;
-}
-
-static void rotate(Transform2D& transform, ezAngle delta)
-{
-  transform.rotation += delta;
-}
-
-static void rotate(ezVec2& vec, ezAngle angle)
-{
-  auto px = vec.x * ezMath::Cos(angle) - vec.y * ezMath::Sin(angle);
-  auto py = vec.x * ezMath::Sin(angle) + vec.y * ezMath::Cos(angle);
-  vec.Set(px, py);
-}
 
 static void registerInputAction(const char* inputSet, const char* inputAction,
                                 const char* szKey1,
@@ -117,89 +44,102 @@ static void registerInputAction(const char* inputSet, const char* inputAction,
   ezInputManager::SetInputActionConfig(inputSet, inputAction, cfg, true);
 }
 
-static ezRectFloat g_levelBounds;
 static Sprite g_bg;
 static Sprite g_life;
-static Ship g_ship;
-static Bullet g_bullet;
+static Sprite g_asteroidBodies[Asteroid::NumLives]; ///< One per number of remaining lives.
+static Sprite g_shipHull;
+static Sprite g_shipThruster;
+static Sprite g_bulletBody;
 static bool g_drawThruster = false;
 static bool g_drawShip = true;
-static ezDynamicArray<Asteroid> g_asteroids;
-
-static float leftOf(const ezRectFloat& rect)
-{
-  return rect.x;
-}
-
-static float rightOf(const ezRectFloat& rect)
-{
-  return rect.x + rect.width;
-}
-
-static float bottomOf(const ezRectFloat& rect)
-{
-  return rect.y;
-}
-
-static float topOf(const ezRectFloat& rect)
-{
-  return rect.y + rect.height;
-}
+static LevelState g_level;
+static LevelInput g_input;
+static GameLog g_gameLog;
+static ezUInt32 g_numInitialAsteroids = 0; ///< From SimulationDesc, used again when the level is reset.
 
 static void extractLevel(Renderer::Extractor& e)
 {
-  extract(e, g_bg, Transform2D::zero());
+  const auto& view = g_level.view;
 
-  if (g_bullet.body.needsUpdate())
+  Transform2D bgTransform = Transform2D::zero();
+  bgTransform.position = level::getCameraPosition();
+  extract(e, g_bg, bgTransform);
+
+  if (g_bulletBody.needsUpdate())
   {
-    update(g_bullet.body);
+    update(g_bulletBody);
   }
 
-  if (g_bullet.isAlive())
+  if (g_level.bullet.isAlive())
   {
-    extract(e, g_bullet.body, g_bullet.transform);
+    extract(e, g_bulletBody, g_level.bullet.transform);
   }
 
-  if (g_ship.isInvulnerable())
+  if (g_level.ship.isInvulnerable())
   {
     g_drawShip =
       !g_drawShip;
   }
+  else
+  {
+    g_drawShip = true;
+  }
 
   if (g_drawShip)
   {
-    if(g_ship.hull.needsUpdate())
+    if(g_shipHull.needsUpdate())
     {
-      update(g_ship.hull);
+      update(g_shipHull);
     }
-    extract(e, g_ship.hull, g_ship.transform);
-    if (ezInputManager::GetInputActionState("game", "thrust") == ezKeyState::Down)
+    extract(e, g_shipHull, g_level.ship.transform);
+    if (g_input.thrust > 0.0f)
     {
-      if (g_ship.isInvulnerable() || g_drawThruster)
+      if (g_level.ship.isInvulnerable() || g_drawThruster)
       {
-        if(g_ship.thruster.needsUpdate())
+        if(g_shipThruster.needsUpdate())
         {
-          update(g_ship.thruster);
+          update(g_shipThruster);
         }
-        extract(e, g_ship.thruster, g_ship.transform);
+        extract(e, g_shipThruster, g_level.ship.transform);
       }
     }
   }
 
   g_drawThruster = !g_drawThruster;
 
-  for (auto& a : g_asteroids)
+  for (auto& body : g_asteroidBodies)
   {
-    if(!a.isAlive())
+    if (body.needsUpdate())
+    {
+      update(body);
+    }
+  }
+
+  // Asteroids stick out of their chunk by up to their radius, and wrapped ones
+  // are even up to 1.1 times their radius outside of the edge chunks.
+  const auto chunkMargin = 1.1f * g_level.world.asteroidRadius;
+  for (auto chunkIndex : g_level.world.activeChunks)
+  {
+    const auto& chunk = g_level.world.chunks[chunkIndex];
+    auto chunkArea = chunk.bounds;
+    chunkArea.x -= chunkMargin;
+    chunkArea.y -= chunkMargin;
+    chunkArea.width += 2.0f * chunkMargin;
+    chunkArea.height += 2.0f * chunkMargin;
+    if (!overlaps(view, chunkArea))
     {
       continue;
     }
 
-    if (a.body.needsUpdate())
+    for (const auto& a : chunk.asteroids)
     {
-      update(a.body);
+      if(!a.isAlive() || !overlaps(view, a.transform.position, a.boundingRadius))
+      {
+        continue;
+      }
+
+      extract(e, g_asteroidBodies[a.lives - 1], a.transform);
     }
-    extract(e, a.body, a.transform);
   }
 
   if (g_life.needsUpdate())
@@ -210,48 +150,24 @@ static void extractLevel(Renderer::Extractor& e)
   const auto lifeMargin = 8;
   Transform2D livesTransfrom;
   livesTransfrom.rotation = ezAngle::Radian(0);
-  livesTransfrom.position = ezVec2(g_levelBounds.x,
-                                   g_levelBounds.y + g_levelBounds.height - g_life.getLocalBounds().height);
+  livesTransfrom.position = ezVec2(view.x,
+                                   view.y + view.height - g_life.getLocalBounds().height);
   livesTransfrom.position.x += lifeMargin;
   livesTransfrom.position.y -= lifeMargin;
-  for (int i = 0; i < g_ship.lives; ++i)
+  for (int i = 0; i < g_level.ship.lives; ++i)
   {
     extract(e, g_life, livesTransfrom);
     livesTransfrom.position.x += g_life.getLocalBounds().width + lifeMargin;
   }
 }
 
-static ezVec2 randomPos()
-{
-  std::uniform_real_distribution<float> xdist(g_levelBounds.x, g_levelBounds.width);
-  std::uniform_real_distribution<float> ydist(g_levelBounds.y, g_levelBounds.height);
-
-  ezVec2 pos;
-  pos.x = xdist(g_randomEngine);
-  pos.y = ydist(g_randomEngine);
-  return pos;
-}
-
-static ezVec2 randomLinearVelocity()
-{
-  std::uniform_real_distribution<float> angleDist(0.0f, 360.0f);
-  std::uniform_real_distribution<float> lengthDist(Asteroid::MinSpeed, Asteroid::MaxSpeed);
-
-  auto angle = ezAngle::Degree(angleDist(g_randomEngine));
-
-  ezVec2 dir(0, 1);
-  rotate(dir, angle);
-
-  return dir * lengthDist(g_randomEngine);
-}
-
 static ezColor randomColor()
 {
   std::uniform_real_distribution<float> dist;
   return ezColor{
-    dist(g_randomEngine),
-    dist(g_randomEngine),
-    dist(g_randomEngine),
+    dist(g_level.random),
+    dist(g_level.random),
+    dist(g_level.random),
     1.0f
   };
 }
@@ -264,107 +180,103 @@ static void center(Sprite& sprite)
   sprite.setLocalBounds(move(bounds));
 }
 
-static Asteroid& spawnAsteroid()
-{
-  auto& a = g_asteroids.ExpandAndGetRef();
-  initialize(a.body, g_textures[2], g_samplers[0], g_shaders[0]);
-  center(a.body);
-  a.boundingRadius = 0.5f * a.body.getLocalBounds().width;
-  //a.body.setColor(randomColor());
-  return a;
-}
-
-template<typename T>
-static SpacialData spatialData(T& obj)
-{
-  return SpacialData{ &obj.transform, &obj.linearVelocity, &obj.boundingRadius };
-}
-
-static bool areColliding(const SpacialData& a, const SpacialData& b)
-{
-  auto diff = b.transform->position - a.transform->position;
-  return diff.IsZero() || diff.GetLength() < *a.boundingRadius + *b.boundingRadius;
-}
-
-static Asteroid& spawnAsteroidRandomized()
-{
-  auto& a = spawnAsteroid();
-  do
-  {
-    a.transform.position = randomPos();
-    // Brute force!
-  } while (areColliding(spatialData(g_ship), spatialData(a)));
-  a.linearVelocity = randomLinearVelocity();
-  return a;
-}
-
-enum { NumInitialAsteroids = 3 };
-
-void level::initialize(ezRectFloat levelBounds)
+void level::initialize(const WorldDesc& desc)
 {
   EZ_LOG_BLOCK("Initialize Level");
 
   std::srand(static_cast<unsigned int>(std::time(nullptr)));
 
-  g_levelBounds = move(levelBounds);
-
   g_textures.ExpandAndGetRef() = Texture::load("<texture>ship.dds");
   g_textures.ExpandAndGetRef() = Texture::load("<texture>thrust.dds");
   g_textures.ExpandAndGetRef() = Texture::load("<texture>asteroid.dds");
   g_textures.ExpandAndGetRef() = Texture::load("<texture>bullet.dds");
   g_textures.ExpandAndGetRef() = Texture::load("<texture>background.dds");
   g_samplers.ExpandAndGetRef() = Sampler::create();
-  g_shaders.ExpandAndGetRef() = ShaderProgram::loadAndLink("<shader>sprite.vs", "<shader>sprite.fs");
+
+  // Shaders
+  // =======
+  enum { OpaqueShader, SpriteShader, TintedSpriteShader };
+  g_shaders.ExpandAndGetRef() = loadShaderVariant("<shader>sprite.vs", "<shader>sprite.fs", 0);
+  g_shaders.ExpandAndGetRef() = loadShaderVariant("<shader>sprite.vs", "<shader>sprite.fs",
+                                                  SpriteShaderFeatures::AlphaTest);
+  g_shaders.ExpandAndGetRef() = loadShaderVariant("<shader>sprite.vs", "<shader>sprite.fs",
+                                                  SpriteShaderFeatures::AlphaTest | SpriteShaderFeatures::Tint);
 
   // Background
   // ==========
-  initialize(g_bg, g_textures[4], g_samplers[0], g_shaders[0]);
+  initialize(g_bg, g_textures[4], g_samplers[0], g_shaders[OpaqueShader]);
   center(g_bg);
   update(g_bg);
 
   // Ship And Thruster
   // =================
   auto shipTex = borrow(g_textures[0]);
-  initialize(g_ship.hull, shipTex, g_samplers[0], g_shaders[0]);
-  center(g_ship.hull);
+  initialize(g_shipHull, shipTex, g_samplers[0], g_shaders[SpriteShader]);
+  center(g_shipHull);
 
   auto thrusterTex = borrow(g_textures[1]);
-  g_ship.thruster.setLocalBounds(ezRectFloat(-16, -64, 0, 0));
-  initialize(g_ship.thruster, thrusterTex, g_samplers[0], g_shaders[0]);
-
-  g_ship.transform.position = ezVec2::ZeroVector();
-  g_ship.transform.rotation = ezAngle();
-  g_ship.boundingRadius = 0.3f * shipTex->getWidth();
+  g_shipThruster.setLocalBounds(ezRectFloat(-16, -64, 0, 0));
+  initialize(g_shipThruster, thrusterTex, g_samplers[0], g_shaders[SpriteShader]);
 
   // Life
   // ====
   g_life.setLocalBounds(ezRectFloat(0,
                                     0,
-                                    0.5f * g_ship.hull.getLocalBounds().width,
-                                    0.5f * g_ship.hull.getLocalBounds().height));
-  initialize(g_life, shipTex, g_samplers[0], g_shaders[0]);
+                                    0.5f * g_shipHull.getLocalBounds().width,
+                                    0.5f * g_shipHull.getLocalBounds().height));
+  initialize(g_life, shipTex, g_samplers[0], g_shaders[SpriteShader]);
 
   // Asteroids
   // =========
-  for (int i = 0; i < NumInitialAsteroids; ++i)
+  auto asteroidTex = borrow(g_textures[2]);
+  for (int i = 0; i < Asteroid::NumLives; ++i)
   {
-    spawnAsteroidRandomized();
+    const auto shrinkAmount = 2.0f * Asteroid::RadiusLossPerLife * (Asteroid::NumLives - 1 - i);
+    auto& body = g_asteroidBodies[i];
+    initialize(body, asteroidTex, g_samplers[0], g_shaders[SpriteShader]);
+    auto bounds = body.getLocalBounds();
+    bounds.width -= shrinkAmount;
+    bounds.height -= shrinkAmount;
+    body.setLocalBounds(bounds);
+    center(body);
   }
 
   // Bullet
   // ======
   auto bulletTex = borrow(g_textures[3]);
-  g_bullet.body.setColor(ezColor::LightCyan);
-  initialize(g_bullet.body, bulletTex, g_samplers[0], g_shaders[0]);
-  center(g_bullet.body);
-  g_bullet.boundingRadius = 0.5f * g_bullet.body.getLocalBounds().width;
+  g_bulletBody.setColor(ezColor::LightCyan);
+  initialize(g_bulletBody, bulletTex, g_samplers[0], g_shaders[TintedSpriteShader]);
+  center(g_bulletBody);
+
+  // Simulation
+  // ==========
+  SimulationDesc simDesc;
+  simDesc.viewBounds = desc.viewBounds;
+  simDesc.worldBounds = desc.worldBounds;
+  simDesc.chunkSize = desc.chunkSize;
+  simDesc.asteroidsPerChunk = desc.asteroidsPerChunk;
+  simDesc.shipRadius = 0.3f * shipTex->getWidth();
+  simDesc.bulletRadius = 0.5f * g_bulletBody.getLocalBounds().width;
+  simDesc.asteroidRadius = 0.5f * g_asteroidBodies[Asteroid::NumLives - 1].getLocalBounds().width;
+  simDesc.seed = g_randomSeed;
+  g_numInitialAsteroids = simDesc.numInitialAsteroids;
+  initialize(g_level, simDesc);
 
   Renderer::addExtractionListener(extractLevel);
 
+  // Gameplay Log
+  // ============
+  if (g_gameLog.start("<log>gameplay.log", true).Failed())
+  {
+    ezLog::Warning("Failed to open the gameplay log.");
+  }
+
   // Input
   // =====
   registerInputAction("main", "quit", ezInputSlot_KeyEscape);
   registerInputAction("main", "reset", ezInputSlot_KeyR);
+  registerInputAction("main", "quickSave", ezInputSlot_KeyF5);
+  registerInputAction("main", "quickLoad", ezInputSlot_KeyF9);
 
   registerInputAction("game", "thrust", ezInputSlot_KeyW, ezInputSlot_KeyUp);
   registerInputAction("game", "turnCCW_keyboard", ezInputSlot_KeyA, ezInputSlot_KeyLeft);
@@ -378,133 +290,91 @@ void level::shutdown()
 
   Renderer::removeExtractionListener(extractLevel);
 
+  g_gameLog.stop();
+  if (g_gameLog.getNumDropped() > 0)
+  {
+    ezLog::Warning("Dropped %llu gameplay log messages.", static_cast<unsigned long long>(g_gameLog.getNumDropped()));
+  }
+
   g_bg.~Sprite();
   g_life.~Sprite();
-  g_ship.~Ship();
-  g_bullet.~Bullet();
-  g_asteroids.Clear();
+  for (auto& body : g_asteroidBodies)
+  {
+    body.~Sprite();
+  }
+  g_shipHull.~Sprite();
+  g_shipThruster.~Sprite();
+  g_bulletBody.~Sprite();
+  reset(g_level.world);
+  g_level.timers.clear();
 
   g_shaders.Clear();
   g_samplers.Clear();
   g_textures.Clear();
 }
 
-static void updateShipRotation()
+ezResult level::saveSnapshot(const char* path)
 {
-  float inputValue;
-  ezAngle turnDelta;
-
-  if(ezInputManager::GetInputActionState("game", "turnCCW_keyboard", &inputValue) == ezKeyState::Down)
+  ezFileWriter file;
+  if (file.Open(path).Failed())
   {
-    turnDelta += g_ship.turnSpeed * inputValue;
+    ezLog::Error("Failed to open snapshot file '%s' for writing.", path);
+    return EZ_FAILURE;
   }
 
-  if(ezInputManager::GetInputActionState("game", "turnCW_keyboard", &inputValue) == ezKeyState::Down)
-  {
-    turnDelta -= g_ship.turnSpeed * inputValue;
-  }
-
-  rotate(g_ship.transform, turnDelta);
+  return writeSnapshot(g_level, file);
 }
 
-static void updateShipMovement(ezTime dt)
+ezResult level::loadSnapshot(const char* path)
 {
-  float inputValue;
-  float thrustValue = 0.0f;
-
-  if(ezInputManager::GetInputActionState("game", "thrust", &inputValue) == ezKeyState::Down)
-  {
-    thrustValue = g_ship.speedIncRate * inputValue;
-  }
-  else
+  ezDynamicArray<ezUInt8> bytes;
+  if (readWholeFile(path, bytes).Failed())
   {
-    // Apply linear damping.
-
-    g_ship.linearVelocity *= 1.0f - g_ship.linearDamping * static_cast<float>(dt.GetSeconds());
+    ezLog::Error("Failed to open snapshot file '%s'.", path);
+    return EZ_FAILURE;
   }
 
-  ezVec2 shipDir(0, 1);
-  rotate(shipDir, g_ship.transform.rotation);
-  g_ship.linearVelocity += (shipDir * thrustValue);
-
-  if(g_ship.linearVelocity.GetLengthSquared() > ezMath::Square(g_ship.maxSpeed))
+  SnapshotView view;
+  if (bytes.IsEmpty() || viewSnapshot(ezArrayPtr<const ezUInt8>(&bytes[0], bytes.GetCount()), view).Failed())
   {
-    g_ship.linearVelocity.Normalize();
-    g_ship.linearVelocity *= g_ship.maxSpeed;
+    ezLog::Error("Failed to load snapshot file '%s'.", path);
+    return EZ_FAILURE;
   }
 
-  auto moveDelta = g_ship.linearVelocity * static_cast<float>(dt.GetSeconds());
-  move(g_ship.transform, moveDelta);
+  restoreSnapshot(view, g_level);
+  updateView(g_level);
+  return EZ_SUCCESS;
 }
 
-static void levelBoundsCheck(SpacialData& spacial)
+ezVec2 level::getCameraPosition()
 {
-  auto& pos = spacial.transform->position;
-  auto radius = 1.1f * *spacial.boundingRadius;
-  if(pos.x < leftOf(g_levelBounds) - radius)   { pos.x = rightOf(g_levelBounds) + radius; }
-  if(pos.x > rightOf(g_levelBounds) + radius)  { pos.x = leftOf(g_levelBounds) - radius; }
-  if(pos.y < bottomOf(g_levelBounds) - radius) { pos.y = topOf(g_levelBounds) + radius; }
-  if(pos.y > topOf(g_levelBounds) + radius)    { pos.y = bottomOf(g_levelBounds) - radius; }
+  const auto& view = g_level.view;
+  return ezVec2(view.x + 0.5f * view.width,
+                view.y + 0.5f * view.height);
 }
 
-static void spawnBullet()
+static LevelInput readInput()
 {
-  ezVec2 shipDir(0, 1);
-  rotate(shipDir, g_ship.transform.rotation);
+  LevelInput input;
 
-  g_bullet.transform = g_ship.transform;
-  g_bullet.transform.position += shipDir * g_ship.boundingRadius;
-
-  g_bullet.linearVelocity = shipDir * g_bullet.speed;
-
-  g_bullet.lifeTime = g_bullet.maxLifeTime;
-}
-
-static void updateBulletMovement(ezTime dt)
-{
-  auto moveDelta = g_bullet.linearVelocity * static_cast<float>(dt.GetSeconds());
-  move(g_bullet.transform, moveDelta);
-}
-
-static void updateAsteroidMovements(ezTime dt)
-{
-  for (auto& a : g_asteroids)
+  if(ezInputManager::GetInputActionState("game", "thrust") == ezKeyState::Down)
   {
-    if(!a.isAlive())
-    {
-      continue;
-    }
-
-    auto moveDelta = a.linearVelocity * static_cast<float>(dt.GetSeconds());
-    move(a.transform, moveDelta);
+    input.thrust = 1.0f;
   }
-}
 
-static void destroy(Asteroid& asteroid)
-{
-  --asteroid.lives;
-
-  if (asteroid.lives < 1)
+  if(ezInputManager::GetInputActionState("game", "turnCCW_keyboard") == ezKeyState::Down)
   {
-    return;
+    input.turn += 1.0f;
   }
 
-  const auto shrinkAmount = 16;
-  const auto degrees = 45.0f;
-
-  asteroid.boundingRadius -= 0.5f * shrinkAmount;
-  auto bounds = asteroid.body.getLocalBounds();
-  bounds.width -= shrinkAmount;
-  bounds.height -= shrinkAmount;
-  asteroid.body.setLocalBounds(bounds);
-  center(asteroid.body);
+  if(ezInputManager::GetInputActionState("game", "turnCW_keyboard") == ezKeyState::Down)
+  {
+    input.turn -= 1.0f;
+  }
 
-  asteroid.linearVelocity = asteroid.linearVelocity.GetLength() * g_bullet.linearVelocity.GetNormalized();
-  rotate(asteroid.linearVelocity, ezAngle::Degree(degrees));
+  input.shoot = ezInputManager::GetInputActionState("game", "shoot") == ezKeyState::Down;
 
-  auto& other = spawnAsteroid();
-  other = asteroid;
-  rotate(other.linearVelocity, ezAngle::Degree(-2.0f * degrees));
+  return input;
 }
 
 void level::update(GameLoopData& gameLoop)
@@ -517,138 +387,47 @@ void level::update(GameLoopData& gameLoop)
     return;
   }
 
-  int numLiveAsteroids = 0;
-  for (auto& a : g_asteroids)
+  if(ezInputManager::GetInputActionState("main", "reset") == ezKeyState::Pressed)
   {
-    if (a.isAlive())
-    {
-      ++numLiveAsteroids;
-    }
+    respawn(g_level, g_numInitialAsteroids);
   }
 
-  if(numLiveAsteroids == 0)
+  if(ezInputManager::GetInputActionState("main", "quickSave") == ezKeyState::Pressed)
   {
-    ezLog::Success("You destroyed all asteroids!");
-    ezLog::Success("Game Over");
-    gameLoop.stop = true;
-    return;
-  }
-
-  if(ezInputManager::GetInputActionState("main", "reset") == ezKeyState::Pressed)
-  {
-    g_ship.transform = Transform2D::zero();
-    g_ship.linearVelocity.SetZero();
-
-    g_bullet.lifeTime = ezTime::Seconds(0.0f);
-
-    g_asteroids.Clear();
-    for (int i = 0; i < NumInitialAsteroids; ++i)
+    if (level::saveSnapshot("<save>quicksave.snapshot").Succeeded())
     {
-      spawnAsteroidRandomized();
+      ezLog::Info("Quick saved.");
     }
   }
 
-  if (g_bullet.isAlive())
+  if(ezInputManager::GetInputActionState("main", "quickLoad") == ezKeyState::Pressed)
   {
-    g_bullet.lifeTime -= gameLoop.dt;
-  }
-
-  if (ezInputManager::GetInputActionState("game", "shoot") == ezKeyState::Down
-      && !g_bullet.isAlive()
-      && !g_ship.isInvulnerable())
-  {
-    spawnBullet();
-  }
-
-  // Update Movement/Rotation
-  // ========================
-
-  // Ship
-  updateShipRotation();
-  updateShipMovement(gameLoop.dt);
-
-  // Bullet
-  updateBulletMovement(gameLoop.dt);
-
-  // Asteroids
-  updateAsteroidMovements(gameLoop.dt);
-
-  // Level Bounds Checking
-  // =====================
-
-  // Ship
-  levelBoundsCheck(spatialData(g_ship));
-
-  // Bullet
-  levelBoundsCheck(spatialData(g_bullet));
-
-  // Asteroids
-  for (auto& a : g_asteroids)
-  {
-    if (!a.isAlive())
+    if (level::loadSnapshot("<save>quicksave.snapshot").Succeeded())
     {
-      continue;
+      ezLog::Info("Quick loaded.");
     }
-
-    levelBoundsCheck(spatialData(a));
   }
 
-  // Collision With Bullet
-  // =====================
-  if (g_bullet.isAlive())
-  {
-    auto bulletSpacial = spatialData(g_bullet);
-    for (auto& a : g_asteroids)
-    {
-      if(!a.isAlive())
-      {
-        continue;
-      }
+  g_input = readInput();
+  auto result = step(g_level, g_input, gameLoop.dt);
 
-      if (areColliding(bulletSpacial, spatialData(a)))
-      {
-        destroy(a);
-        g_bullet.lifeTime = ezTime::Seconds(0);
-        break;
-      }
-    }
-  }
+  const auto gameTime = g_level.world.time;
 
-  // Collision With Ship
-  // ===================
-  if (g_ship.isInvulnerable())
+  if(result.allAsteroidsDestroyed)
   {
-    g_ship.invulnerableTime -= gameLoop.dt;
-
-    if (!g_ship.isInvulnerable())
-    {
-      g_drawShip = true;
-    }
+    g_gameLog.log(GameLogRecord::AllAsteroidsDestroyed, 0, gameTime);
+    gameLoop.stop = true;
+    return;
   }
-  else
-  {
-    auto shipSpacial = spatialData(g_ship);
-    for(auto& a : g_asteroids)
-    {
-      if(!a.isAlive())
-      {
-        continue;
-      }
 
-      if(areColliding(shipSpacial, spatialData(a)))
-      {
-        ezLog::Info("You ship was hit!");
-        --g_ship.lives;
-        g_ship.invulnerableTime = ezTime::Seconds(2);
-        ezLog::Info("Remaining lives: %d", g_ship.lives);
-      }
-    }
+  for (ezUInt32 i = 0; i < result.numShipHits; ++i)
+  {
+    g_gameLog.log(GameLogRecord::ShipHit, g_level.ship.lives + static_cast<int>(result.numShipHits - 1 - i), gameTime);
   }
 
-  if (g_ship.lives < 1)
+  if (result.shipDestroyed)
   {
-    ezLog::Info("Your ship was destroyed.");
-    ezLog::Info("Game Over");
+    g_gameLog.log(GameLogRecord::ShipDestroyed, 0, gameTime);
     gameLoop.stop = true;
     return;
   }
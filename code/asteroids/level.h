@@ -3,7 +3,27 @@
 
 namespace level
 {
-  void initialize(ezRectFloat levelBounds);
+  struct WorldDesc
+  {
+    ezRectFloat viewBounds;  ///< Visible part of the world, the camera starts at its center.
+    ezRectFloat worldBounds; ///< Everything wraps around at these bounds.
+
+    /// Size of the square chunks the world is split into. With 0 the whole
+    /// world is a single chunk and the camera stays fixed, otherwise the
+    /// camera follows the ship and only chunks near it are simulated.
+    float chunkSize = 0.0f;
+
+    /// Asteroids spawned in each chunk the first time it comes close to the camera.
+    ezUInt32 asteroidsPerChunk = 0;
+  };
+
+  void initialize(const WorldDesc& desc);
   void shutdown();
   void update(GameLoopData& gameLoop);
+
+  ezVec2 getCameraPosition();
+
+  /// \brief Writes a snapshot of the current level state, see snapshot.h.
+  ezResult saveSnapshot(const char* path);
+  ezResult loadSnapshot(const char* path);
 }
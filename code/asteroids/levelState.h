@@ -0,0 +1,63 @@
+#pragma once
+
+#include <asteroids/random.h>
+#include <asteroids/timingWheel.h>
+#include <asteroids/world.h>
+
+struct LevelEvent
+{
+  enum Type { BulletExpired, ShipVulnerable };
+
+  Type type;
+};
+
+struct Ship
+{
+  enum { NumLives = 3 };
+
+  kr::Transform2D transform = kr::Transform2D::zero();
+  ezVec2 linearVelocity = ezVec2::ZeroVector();
+  float boundingRadius = 0.0f;
+  float speedIncRate = 300.0f; ///< Meters per second per second.
+  float maxSpeed = 300.0f;
+  float linearDamping = 0.9f; ///< Percentual reduction per frame.
+  ezAngle turnSpeed = ezAngle::Degree(360.0f);
+  ezTime invulnerableDuration = ezTime::Seconds(2);
+  int lives = NumLives;
+  bool invulnerable = false;
+  TimerHandle invulnerableTimer;
+
+  bool isInvulnerable() const { return this->invulnerable; }
+};
+
+struct Bullet
+{
+  kr::Transform2D transform = kr::Transform2D::zero();
+  ezVec2 linearVelocity = ezVec2::ZeroVector();
+  float boundingRadius = 0.0f;
+
+  float speed = 500.0f; // Meters per second.
+  ezTime maxLifeTime = ezTime::Seconds(1);
+  bool alive = false;
+  TimerHandle lifeTimer;
+
+  bool isAlive() const { return this->alive; }
+};
+
+/// \brief Everything that is simulated in a level, without any rendering resources.
+///
+/// This is a plain value type: Copying it clones the level, which reuses the
+/// memory of the target once it has seen a level of similar size.
+struct LevelState
+{
+  Ship ship;
+  Bullet bullet;
+  World world;
+  TimingWheel<LevelEvent> timers;
+  RandomEngine random;
+
+  /// The visible part of the world. Follows the ship in chunked worlds.
+  ezRectFloat view;
+  bool viewFollowsShip = false;
+  float activeMargin = 0.0f; ///< How far around the view chunks are simulated.
+};
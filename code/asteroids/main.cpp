@@ -1,6 +1,7 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Logging/ConsoleWriter.h>
 #include <Foundation/Logging/VisualStudioWriter.h>
 #include <Foundation/Logging/HTMLWriter.h>
@@ -9,6 +10,14 @@
 
 #include <asteroids/gameLoop.h>
 #include <asteroids/level.h>
+#include <asteroids/benchmarks.h>
+#include <asteroids/botBatch.h>
+#include <asteroids/shaderCache.h>
+#include <asteroids/framePacer.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 
 void mountAsteroidsDataDirs()
 {
@@ -35,6 +44,24 @@ void mountAsteroidsDataDirs()
     EZ_VERIFY(ezFileSystem::AddDataDirectory(texDir.GetData(), ezFileSystem::ReadOnly, "data", "texture").Succeeded(),
               "Failed to mount textures directory.");
   }
+
+  // Shader Cache
+  {
+    ezStringBuilder cacheDir(appDir);
+    cacheDir.AppendPath("shaderCache");
+    ezOSFile::CreateDirectoryStructure(cacheDir.GetData());
+
+    // To be used as "<shadercache>0123456789abcdef.vs"
+    EZ_VERIFY(ezFileSystem::AddDataDirectory(cacheDir.GetData(), ezFileSystem::AllowWrites, "shaderCache", "shadercache").Succeeded(),
+              "Failed to mount shader cache directory.");
+  }
+
+  // Saves
+  {
+    // To be used as "<save>quicksave.snapshot"
+    EZ_VERIFY(ezFileSystem::AddDataDirectory(appDir, ezFileSystem::AllowWrites, "save", "save").Succeeded(),
+              "Failed to mount saves directory.");
+  }
 }
 
 struct BasicLogging
@@ -95,6 +122,9 @@ struct Cam
 
   void extract(kr::Renderer::Extractor& e)
   {
+    auto pos = level::getCameraPosition();
+    this->cam.LookAt(ezVec3(pos.x, pos.y, 0.5f), // Camera Position.
+                     ezVec3(pos.x, pos.y, 0));   // Target Position.
     kr::extract(e, this->cam, this->aspect);
   }
 
@@ -102,6 +132,17 @@ struct Cam
   ezCamera cam;
 };
 
+void exportFrameStats(const FramePacer& pacer)
+{
+  pacer.logSummary();
+
+  ezFileWriter file;
+  if(file.Open("<log>frameStats.csv").Failed() || pacer.writeHistograms(file).Failed())
+  {
+    ezLog::Error("Failed to write frame statistics.");
+  }
+}
+
 kr::Owned<kr::Window> createAsteroidsWindow()
 {
   ezWindowCreationDesc desc;
@@ -112,6 +153,60 @@ kr::Owned<kr::Window> createAsteroidsWindow()
   return kr::Window::createAndOpen(desc);
 }
 
+bool hasArgument(int argc, char* argv[], const char* arg)
+{
+  for(int i = 1; i < argc; ++i)
+  {
+    if(std::strcmp(argv[i], arg) == 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// \brief Returns the value following \a arg, or \a defaultValue if there is none.
+const char* getArgumentValue(int argc, char* argv[], const char* arg, const char* defaultValue)
+{
+  for(int i = 1; i < argc - 1; ++i)
+  {
+    if(std::strcmp(argv[i], arg) == 0)
+    {
+      return argv[i + 1];
+    }
+  }
+
+  return defaultValue;
+}
+
+/// \brief Parses the value following \a arg as a decimal number in [\a minValue, \a maxValue].
+///
+/// Uses \a defaultValue if \a arg is not given. Anything else, including negative numbers
+/// and trailing characters, is logged as an error.
+ezResult getUnsignedArgument(int argc, char* argv[], const char* arg, ezUInt32 defaultValue,
+                             ezUInt32 minValue, ezUInt32 maxValue, ezUInt32& out)
+{
+  const char* text = getArgumentValue(argc, argv, arg, nullptr);
+  if(text == nullptr)
+  {
+    out = defaultValue;
+    return EZ_SUCCESS;
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  const auto value = std::strtoul(text, &end, 10);
+  if(text[0] < '0' || text[0] > '9' || *end != '\0' || errno == ERANGE || value < minValue || value > maxValue)
+  {
+    ezLog::Error("Invalid value '%s' for %s, expected a number from %u to %u.", text, arg, minValue, maxValue);
+    return EZ_FAILURE;
+  }
+
+  out = static_cast<ezUInt32>(value);
+  return EZ_SUCCESS;
+}
+
 int main(int argc, char* argv[])
 {
   {
@@ -126,6 +221,48 @@ int main(int argc, char* argv[])
 
     mountAsteroidsDataDirs();
 
+    if(hasArgument(argc, argv, "-benchRollback"))
+    {
+      benchmarkRollback();
+      return 0;
+    }
+
+    if(hasArgument(argc, argv, "-benchField"))
+    {
+      benchmarkAsteroidField();
+      return 0;
+    }
+
+    if(hasArgument(argc, argv, "-cacheShaders"))
+    {
+      cacheAllSpriteShaderVariants();
+      return 0;
+    }
+
+    if(hasArgument(argc, argv, "-botBatch"))
+    {
+      BotBatchDesc batch;
+      if(getUnsignedArgument(argc, argv, "-botGames", 64, 1, BotBatchDesc::MaxGamesPerTuning, batch.gamesPerTuning).Failed()
+         || getUnsignedArgument(argc, argv, "-botThreads", 0, 0, BotBatchDesc::MaxThreads, batch.numThreads).Failed())
+      {
+        return 1;
+      }
+      const char* pilot = getArgumentValue(argc, argv, "-botPilot", toString(batch.pilot));
+      if(fromString(pilot, batch.pilot).Failed())
+      {
+        ezLog::Error("Invalid value '%s' for -botPilot, expected 'hunter' or 'scripted'.", pilot);
+        return 1;
+      }
+      return runTuningSweep(kr::move(batch), "<save>botBatch.csv").Succeeded() ? 0 : 1;
+    }
+
+    // Checked before anything is created. Running uncapped is only possible with -uncapped.
+    ezUInt32 framesPerSecond = 0;
+    if(getUnsignedArgument(argc, argv, "-fps", 60, 1, 1000, framesPerSecond).Failed())
+    {
+      return 1;
+    }
+
     {
       GameLoopData gameLoop;
 
@@ -158,26 +295,53 @@ int main(int argc, char* argv[])
                               );
       levelBounds.x = -0.5f * levelBounds.width;
       levelBounds.y = -0.5f * levelBounds.height;
-      level::initialize(levelBounds);
+
+      level::WorldDesc worldDesc;
+      worldDesc.viewBounds = levelBounds;
+      worldDesc.worldBounds = levelBounds;
+      if(hasArgument(argc, argv, "-largeWorld"))
+      {
+        const auto worldScale = 64.0f;
+        worldDesc.worldBounds.x *= worldScale;
+        worldDesc.worldBounds.y *= worldScale;
+        worldDesc.worldBounds.width *= worldScale;
+        worldDesc.worldBounds.height *= worldScale;
+        worldDesc.chunkSize = levelBounds.width;
+        worldDesc.asteroidsPerChunk = 2;
+      }
+      level::initialize(worldDesc);
       KR_ON_SCOPE_EXIT{ level::shutdown(); };
 
+      // Frame Pacing
+      // ============
+      FramePacer pacer;
+      if(hasArgument(argc, argv, "-uncapped"))
+      {
+        pacer.setTargetFrameRate(0.0);
+      }
+      else
+      {
+        pacer.setTargetFrameRate(framesPerSecond);
+      }
+      KR_ON_SCOPE_EXIT{ exportFrameStats(pacer); };
+
       // Game Loop
       // =========
-      auto now = ezTime::Now();
       while(true)
       {
-        gameLoop.dt = ezTime::Now() - now;
+        gameLoop.dt = pacer.beginFrame();
 
-        level::update(gameLoop);
+        // Window messages first, so the input read by the level is as fresh as possible.
+        kr::processWindowMessages(window);
         if(gameLoop.stop) break;
 
-        kr::processWindowMessages(window);
+        level::update(gameLoop);
         if(gameLoop.stop) break;
 
         kr::Renderer::extract();
         kr::Renderer::update(gameLoop.dt, window);
 
-        now += gameLoop.dt;
+        pacer.endFrame();
       }
     }
   }
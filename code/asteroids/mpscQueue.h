@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/// \brief Bounded, lock-free queue for many producer threads and a single consumer thread.
+///
+/// Every slot carries a sequence number that tells whether it is free for the
+/// producer of a given position or ready for the consumer. Producers claim a
+/// position with a single compare-and-swap and never wait for each other or
+/// for the consumer: when the queue is full, tryPush() fails right away.
+/// The capacity is fixed at construction and nothing allocates afterwards.
+template<typename T>
+class MpscQueue
+{
+public:
+  /// \a capacity is rounded up to the next power of two.
+  explicit MpscQueue(ezUInt32 capacity)
+  {
+    ezUInt32 size = 1;
+    while(size < capacity)
+    {
+      size *= 2;
+    }
+
+    this->mask = size - 1;
+    this->slots.reset(new Slot[size]);
+    for(ezUInt32 i = 0; i < size; ++i)
+    {
+      this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /// \brief May be called from any thread.
+  /// \return \c false if the queue is full.
+  bool tryPush(const T& value)
+  {
+    auto pos = this->pushPos.load(std::memory_order_relaxed);
+    while(true)
+    {
+      auto& slot = this->slots[static_cast<ezUInt32>(pos) & this->mask];
+      auto sequence = slot.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<ezInt64>(sequence - pos);
+      if(diff == 0)
+      {
+        if(this->pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          slot.value = value;
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if(diff < 0)
+      {
+        // The consumer has not taken the value a whole lap ago yet.
+        return false;
+      }
+      else
+      {
+        pos = this->pushPos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// \brief Must only be called from the consumer thread.
+  /// \return \c false if the queue is empty.
+  bool tryPop(T& out_value)
+  {
+    auto& slot = this->slots[static_cast<ezUInt32>(this->popPos) & this->mask];
+    if(slot.sequence.load(std::memory_order_acquire) != this->popPos + 1)
+    {
+      return false;
+    }
+
+    out_value = slot.value;
+    slot.sequence.store(this->popPos + this->mask + 1, std::memory_order_release);
+    ++this->popPos;
+    return true;
+  }
+
+  ezUInt32 getCapacity() const { return this->mask + 1; }
+
+private:
+  struct Slot
+  {
+    std::atomic<ezUInt64> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Slot[]> slots; ///< Atomics can't be moved, so they can't live in an ezDynamicArray.
+  ezUInt32 mask = 0;
+  std::atomic<ezUInt64> pushPos{ 0 };
+  ezUInt64 popPos = 0; ///< Only touched by the consumer.
+};
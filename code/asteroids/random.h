@@ -0,0 +1,46 @@
+#pragma once
+
+/// \brief Small PCG32 random engine that can be used with the <random> distributions.
+///
+/// Unlike the std engines, its whole state is a single integer that can be
+/// stored and restored directly, and it yields the same sequence on all platforms.
+struct RandomEngine
+{
+  typedef ezUInt32 result_type;
+
+  static result_type min() { return 0; }
+  static result_type max() { return 0xFFFFFFFFu; }
+
+  ezUInt64 state = 0;
+
+  RandomEngine() = default;
+
+  explicit RandomEngine(ezUInt64 seed)
+  {
+    this->state = seed + Increment;
+    (*this)();
+  }
+
+  result_type operator()()
+  {
+    auto oldState = this->state;
+    this->state = oldState * Multiplier + Increment;
+
+    auto xorShifted = static_cast<ezUInt32>(((oldState >> 18u) ^ oldState) >> 27u);
+    auto rotation = static_cast<ezUInt32>(oldState >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+  }
+
+  /// \brief Uniformly distributed in [\a min, \a max).
+  ///
+  /// Unlike std::uniform_real_distribution, which is implemented differently
+  /// by every standard library, this gives the same values everywhere.
+  float uniform(float min, float max)
+  {
+    return min + (max - min) * (((*this)() >> 8) * (1.0f / 16777216.0f));
+  }
+
+private:
+  static const ezUInt64 Multiplier = 6364136223846793005ull;
+  static const ezUInt64 Increment = 1442695040888963407ull;
+};
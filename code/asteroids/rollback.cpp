@@ -0,0 +1,66 @@
+#include <asteroids/rollback.h>
+
+RollbackBuffer::RollbackBuffer(ezUInt32 numTicks, ezTime tickDuration)
+{
+  EZ_ASSERT_DEV(numTicks > 0, "A rollback buffer needs to hold at least one tick.");
+  this->frames.SetCount(numTicks);
+  this->tickDuration = tickDuration;
+}
+
+LevelStepResult RollbackBuffer::advance(LevelState& state, const LevelInput& input)
+{
+  auto& frame = this->frameOf(this->currentTick);
+  frame.state = state;
+  frame.input = input;
+
+  ++this->currentTick;
+  if(this->currentTick - this->oldestTick > this->frames.GetCount())
+  {
+    this->oldestTick = this->currentTick - this->frames.GetCount();
+  }
+
+  return step(state, input, this->tickDuration);
+}
+
+bool RollbackBuffer::rewind(ezUInt64 tick, LevelState& state)
+{
+  if(!this->isRecorded(tick))
+  {
+    return false;
+  }
+
+  state = this->frameOf(tick).state;
+  this->currentTick = tick;
+  return true;
+}
+
+static void accumulate(LevelStepResult& total, const LevelStepResult& result)
+{
+  total.numShipHits += result.numShipHits;
+  total.numAsteroidHits += result.numAsteroidHits;
+  total.numAsteroidsDestroyed += result.numAsteroidsDestroyed;
+  total.shipDestroyed = total.shipDestroyed || result.shipDestroyed;
+  total.allAsteroidsDestroyed = total.allAsteroidsDestroyed || result.allAsteroidsDestroyed;
+}
+
+bool RollbackBuffer::correctInput(ezUInt64 tick, const LevelInput& input, LevelState& state, LevelStepResult& result)
+{
+  if(!this->isRecorded(tick))
+  {
+    return false;
+  }
+
+  auto& corrected = this->frameOf(tick);
+  corrected.input = input;
+  state = corrected.state;
+  result = step(state, input, this->tickDuration);
+
+  for(auto t = tick + 1; t < this->currentTick; ++t)
+  {
+    auto& frame = this->frameOf(t);
+    frame.state = state;
+    accumulate(result, step(state, frame.input, this->tickDuration));
+  }
+
+  return true;
+}
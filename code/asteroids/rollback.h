@@ -0,0 +1,53 @@
+#pragma once
+
+#include <asteroids/simulation.h>
+
+/// \brief Keeps the last few ticks of a simulation around so they can be re-simulated with corrected input.
+///
+/// For every tick, the state before the tick and the input used for it are
+/// stored in a ring of fixed size. The ring never grows; once every slot has
+/// held a state of typical size, recording and rewinding does not allocate.
+/// All ticks use the same fixed time step, which keeps re-simulation exact.
+class RollbackBuffer
+{
+public:
+  RollbackBuffer(ezUInt32 numTicks, ezTime tickDuration);
+
+  /// \brief Records \a state and \a input for the current tick and simulates it.
+  LevelStepResult advance(LevelState& state, const LevelInput& input);
+
+  /// \brief Sets \a state back to the beginning of tick \a tick and forgets all later ticks.
+  /// \return \c false if \a tick is no longer (or not yet) recorded.
+  bool rewind(ezUInt64 tick, LevelState& state);
+
+  /// \brief Replaces the input of tick \a tick and re-simulates \a state up to the current tick.
+  ///
+  /// \a result receives what happened during all re-simulated ticks: the hit counts are
+  /// summed up and a flag is set if it was set for any of the ticks. Comparing it with
+  /// the results reported for the same ticks before tells what the correction changed.
+  /// \return \c false if \a tick is no longer (or not yet) recorded. \a result is left untouched then.
+  bool correctInput(ezUInt64 tick, const LevelInput& input, LevelState& state, LevelStepResult& result);
+
+  /// The tick that will be simulated by the next call to advance().
+  ezUInt64 getCurrentTick() const { return this->currentTick; }
+
+  /// The oldest tick that can still be rewound to.
+  ezUInt64 getOldestTick() const { return this->oldestTick; }
+
+  ezTime getTickDuration() const { return this->tickDuration; }
+
+private:
+  struct Frame
+  {
+    LevelState state; ///< State at the beginning of the tick.
+    LevelInput input;
+  };
+
+  Frame& frameOf(ezUInt64 tick) { return this->frames[static_cast<ezUInt32>(tick % this->frames.GetCount())]; }
+  bool isRecorded(ezUInt64 tick) const { return tick >= this->getOldestTick() && tick < this->currentTick; }
+
+  ezDynamicArray<Frame> frames;
+  ezTime tickDuration;
+  ezUInt64 currentTick = 0;
+  ezUInt64 oldestTick = 0;
+};
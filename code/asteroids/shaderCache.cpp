@@ -0,0 +1,104 @@
+#include <asteroids/shaderCache.h>
+#include <asteroids/fileUtils.h>
+
+#include <Foundation/IO/FileSystem/FileWriter.h>
+
+static ezResult readText(const char* path, ezStringBuilder& out)
+{
+  ezDynamicArray<ezUInt8> bytes;
+  if(readWholeFile(path, bytes).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  bytes.PushBack('\0');
+  out = reinterpret_cast<const char*>(&bytes[0]);
+  return EZ_SUCCESS;
+}
+
+/// \brief Writes \a text to \a path unless the file already has exactly that content.
+///
+/// The content is compared by hash, so a file that was cut short, e.g. by a
+/// crash while writing it, is replaced instead of being reused forever.
+static ezResult writeIfChanged(const char* path, const ezStringBuilder& text)
+{
+  ezDynamicArray<ezUInt8> existing;
+  if(readWholeFile(path, existing).Succeeded()
+     && existing.GetCount() == text.GetElementCount()
+     && (existing.IsEmpty()
+         || hashShaderSource(reinterpret_cast<const char*>(&existing[0]), existing.GetCount())
+            == hashShaderSource(text.GetData(), text.GetElementCount())))
+  {
+    return EZ_SUCCESS;
+  }
+
+  ezFileWriter file;
+  if(file.Open(path).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  return file.WriteBytes(text.GetData(), text.GetElementCount());
+}
+
+ezResult cacheShaderVariant(const char* vsPath, const char* fsPath, ezUInt32 features,
+                            ezStringBuilder& cachedVsPath, ezStringBuilder& cachedFsPath)
+{
+  ezStringBuilder vsSource;
+  ezStringBuilder fsSource;
+  if(readText(vsPath, vsSource).Failed() || readText(fsPath, fsSource).Failed())
+  {
+    ezLog::Error("Failed to read shader sources '%s' and '%s'.", vsPath, fsPath);
+    return EZ_FAILURE;
+  }
+
+  ezStringBuilder vsVariant;
+  ezStringBuilder fsVariant;
+  makeShaderVariant(vsSource.GetData(), features, vsVariant);
+  makeShaderVariant(fsSource.GetData(), features, fsVariant);
+
+  auto key = static_cast<unsigned long long>(shaderProgramKey(vsVariant, fsVariant));
+  cachedVsPath.Format("<shadercache>%016llx.vs", key);
+  cachedFsPath.Format("<shadercache>%016llx.fs", key);
+
+  if(writeIfChanged(cachedVsPath.GetData(), vsVariant).Failed()
+     || writeIfChanged(cachedFsPath.GetData(), fsVariant).Failed())
+  {
+    ezLog::Error("Failed to write shader variant %016llx to the cache.", key);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+kr::Owned<kr::ShaderProgram> loadShaderVariant(const char* vsPath, const char* fsPath, ezUInt32 features)
+{
+  ezStringBuilder cachedVsPath;
+  ezStringBuilder cachedFsPath;
+  if(cacheShaderVariant(vsPath, fsPath, features, cachedVsPath, cachedFsPath).Failed())
+  {
+    // Without defines, the sources are still a working shader, just without any of the features.
+    ezStringBuilder featureNames;
+    appendFeatureNames(features, featureNames);
+    ezLog::Error("Shader variant of '%s' and '%s' is unavailable, falling back to the plain sources without: %s",
+                 vsPath, fsPath, featureNames.GetData());
+    return kr::ShaderProgram::loadAndLink(vsPath, fsPath);
+  }
+
+  return kr::ShaderProgram::loadAndLink(cachedVsPath.GetData(), cachedFsPath.GetData());
+}
+
+void cacheAllSpriteShaderVariants()
+{
+  EZ_LOG_BLOCK("Sprite Shader Variants");
+
+  for(ezUInt32 features = 0; features < SpriteShaderFeatures::NumVariants; ++features)
+  {
+    ezStringBuilder cachedVsPath;
+    ezStringBuilder cachedFsPath;
+    if(cacheShaderVariant("<shader>sprite.vs", "<shader>sprite.fs", features, cachedVsPath, cachedFsPath).Succeeded())
+    {
+      ezLog::Info("Features 0x%x: %s, %s", features, cachedVsPath.GetData(), cachedFsPath.GetData());
+    }
+  }
+}
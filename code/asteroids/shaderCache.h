@@ -0,0 +1,23 @@
+#pragma once
+
+#include <asteroids/shaderVariants.h>
+
+/// \file
+/// On-disk cache of generated shader variants, mounted as "<shadercache>".
+///
+/// krEngine compiles shaders from files only, so every variant is written to the
+/// cache as a pair of files named after shaderProgramKey() of its sources. A file
+/// that is already there is reused as is, and changing a shader or the set of
+/// defines results in a new key instead of a stale cache hit.
+
+/// \brief Makes sure the variant \a features of \a vsPath and \a fsPath is in the cache and returns the paths of its sources.
+///
+/// Does not need a GPU.
+ezResult cacheShaderVariant(const char* vsPath, const char* fsPath, ezUInt32 features,
+                            ezStringBuilder& cachedVsPath, ezStringBuilder& cachedFsPath);
+
+/// \brief Loads and links the variant \a features of \a vsPath and \a fsPath through the cache.
+kr::Owned<kr::ShaderProgram> loadShaderVariant(const char* vsPath, const char* fsPath, ezUInt32 features);
+
+/// \brief Puts all variants of the sprite shader into the cache and logs their keys.
+void cacheAllSpriteShaderVariants();
@@ -0,0 +1,61 @@
+#include <asteroids/shaderVariants.h>
+
+#include <cstring>
+
+void appendFeatureDefines(ezUInt32 features, ezStringBuilder& out)
+{
+  if(features & SpriteShaderFeatures::Instanced) out.Append("#define SPRITE_INSTANCED 1\n");
+  if(features & SpriteShaderFeatures::AlphaTest) out.Append("#define SPRITE_ALPHA_TEST 1\n");
+  if(features & SpriteShaderFeatures::Tint)      out.Append("#define SPRITE_TINT 1\n");
+}
+
+void appendFeatureNames(ezUInt32 features, ezStringBuilder& out)
+{
+  if(features == 0)
+  {
+    out.Append("none");
+    return;
+  }
+
+  const char* separator = "";
+  if(features & SpriteShaderFeatures::Instanced) { out.Append(separator); out.Append("SPRITE_INSTANCED");  separator = " "; }
+  if(features & SpriteShaderFeatures::AlphaTest) { out.Append(separator); out.Append("SPRITE_ALPHA_TEST"); separator = " "; }
+  if(features & SpriteShaderFeatures::Tint)      { out.Append(separator); out.Append("SPRITE_TINT");       separator = " "; }
+}
+
+void makeShaderVariant(const char* source, ezUInt32 features, ezStringBuilder& out)
+{
+  // GLSL wants the #version directive before anything else.
+  const char* body = source;
+  auto version = std::strstr(source, "#version");
+  if(version != nullptr)
+  {
+    auto lineEnd = std::strchr(version, '\n');
+    body = lineEnd != nullptr ? lineEnd + 1 : version + std::strlen(version);
+  }
+
+  out.SetSubString_FromTo(source, body);
+  if(body == source + std::strlen(source) && body != source && body[-1] != '\n')
+  {
+    out.Append("\n");
+  }
+  appendFeatureDefines(features, out);
+  out.Append(body);
+}
+
+ezUInt64 hashShaderSource(const char* data, ezUInt32 size, ezUInt64 hash)
+{
+  for(ezUInt32 i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<ezUInt8>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+ezUInt64 shaderProgramKey(const ezStringBuilder& vsSource, const ezStringBuilder& fsSource)
+{
+  // Hash the terminator too, so moving text from one stage to the other changes the key.
+  auto hash = hashShaderSource(vsSource.GetData(), vsSource.GetElementCount() + 1);
+  return hashShaderSource(fsSource.GetData(), fsSource.GetElementCount() + 1, hash);
+}
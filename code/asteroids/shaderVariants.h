@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Foundation/Strings/StringBuilder.h>
+
+/// \file
+/// Generating shader variants from preprocessor defines. None of this touches the GPU.
+
+/// \brief Features of the sprite shader that are compiled in or out.
+struct SpriteShaderFeatures
+{
+  enum : ezUInt32
+  {
+    Instanced = 1 << 0, ///< SPRITE_INSTANCED
+    AlphaTest = 1 << 1, ///< SPRITE_ALPHA_TEST
+    Tint      = 1 << 2, ///< SPRITE_TINT
+
+    NumVariants = 1 << 3
+  };
+};
+
+/// \brief Appends one `#define` line per set flag of \a features to \a out, always in the same order.
+void appendFeatureDefines(ezUInt32 features, ezStringBuilder& out);
+
+/// \brief Appends the names of the defines of \a features to \a out, separated by spaces, or "none".
+void appendFeatureNames(ezUInt32 features, ezStringBuilder& out);
+
+/// \brief Makes the source of a variant by inserting the defines of \a features right after the `#version` line of \a source.
+void makeShaderVariant(const char* source, ezUInt32 features, ezStringBuilder& out);
+
+/// \brief 64 bit FNV-1a hash of \a size bytes of \a data, continuing from \a hash.
+ezUInt64 hashShaderSource(const char* data, ezUInt32 size, ezUInt64 hash = 14695981039346656037ull);
+
+/// \brief Identifies the program linked from the given variant sources.
+ezUInt64 shaderProgramKey(const ezStringBuilder& vsSource, const ezStringBuilder& fsSource);
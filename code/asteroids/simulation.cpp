@@ -0,0 +1,351 @@
+#include <asteroids/simulation.h>
+#include <asteroids/asteroidField.h>
+
+using namespace kr;
+
+namespace
+{
+  struct SpacialData
+  {
+    Transform2D* transform;
+    ezVec2* linearVelocity;
+    float* boundingRadius;
+  };
+}
+
+static void move(Transform2D& transform, const ezVec2& delta)
+{
+  transform.position += delta;
+}
+
+static void rotate(Transform2D& transform, ezAngle delta)
+{
+  transform.rotation += delta;
+}
+
+static void rotate(ezVec2& vec, ezAngle angle)
+{
+  auto px = vec.x * ezMath::Cos(angle) - vec.y * ezMath::Sin(angle);
+  auto py = vec.x * ezMath::Sin(angle) + vec.y * ezMath::Cos(angle);
+  vec.Set(px, py);
+}
+
+template<typename T>
+static SpacialData spatialData(T& obj)
+{
+  return SpacialData{ &obj.transform, &obj.linearVelocity, &obj.boundingRadius };
+}
+
+static bool areColliding(const SpacialData& a, const SpacialData& b)
+{
+  auto diff = b.transform->position - a.transform->position;
+  return diff.IsZero() || diff.GetLength() < *a.boundingRadius + *b.boundingRadius;
+}
+
+static void levelBoundsCheck(LevelState& state, const SpacialData& spacial)
+{
+  wrapAround(state.world.bounds, spacial.transform->position, *spacial.boundingRadius);
+}
+
+static void spawnBullet(LevelState& state)
+{
+  auto& ship = state.ship;
+  auto& bullet = state.bullet;
+
+  ezVec2 shipDir(0, 1);
+  rotate(shipDir, ship.transform.rotation);
+
+  bullet.transform = ship.transform;
+  bullet.transform.position += shipDir * ship.boundingRadius;
+
+  bullet.linearVelocity = shipDir * bullet.speed;
+
+  bullet.alive = true;
+  state.timers.cancel(bullet.lifeTimer);
+  bullet.lifeTimer = state.timers.schedule(bullet.maxLifeTime, LevelEvent{ LevelEvent::BulletExpired });
+}
+
+static void killBullet(LevelState& state)
+{
+  state.bullet.alive = false;
+  state.timers.cancel(state.bullet.lifeTimer);
+}
+
+static void makeShipInvulnerable(LevelState& state)
+{
+  auto& ship = state.ship;
+  ship.invulnerable = true;
+  state.timers.cancel(ship.invulnerableTimer);
+  ship.invulnerableTimer = state.timers.schedule(ship.invulnerableDuration, LevelEvent{ LevelEvent::ShipVulnerable });
+}
+
+static void handleTimedEvents(LevelState& state, ezArrayPtr<LevelEvent> events)
+{
+  for (ezUInt32 i = 0; i < events.GetCount(); ++i)
+  {
+    switch (events[i].type)
+    {
+    case LevelEvent::BulletExpired:
+      state.bullet.alive = false;
+      state.bullet.lifeTimer.invalidate();
+      break;
+    case LevelEvent::ShipVulnerable:
+      state.ship.invulnerable = false;
+      state.ship.invulnerableTimer.invalidate();
+      break;
+    }
+  }
+}
+
+static void updateShipRotation(LevelState& state, const LevelInput& input, ezTime dt)
+{
+  auto turnDelta = state.ship.turnSpeed * (ezMath::Clamp(input.turn, -1.0f, 1.0f) * static_cast<float>(dt.GetSeconds()));
+  rotate(state.ship.transform, turnDelta);
+}
+
+static void updateShipMovement(LevelState& state, const LevelInput& input, ezTime dt)
+{
+  auto& ship = state.ship;
+  float thrustValue = 0.0f;
+
+  if(input.thrust > 0.0f)
+  {
+    thrustValue = ship.speedIncRate * ezMath::Min(input.thrust, 1.0f) * static_cast<float>(dt.GetSeconds());
+  }
+  else
+  {
+    // Apply linear damping.
+
+    ship.linearVelocity *= 1.0f - ship.linearDamping * static_cast<float>(dt.GetSeconds());
+  }
+
+  ezVec2 shipDir(0, 1);
+  rotate(shipDir, ship.transform.rotation);
+  ship.linearVelocity += (shipDir * thrustValue);
+
+  if(ship.linearVelocity.GetLengthSquared() > ezMath::Square(ship.maxSpeed))
+  {
+    ship.linearVelocity.Normalize();
+    ship.linearVelocity *= ship.maxSpeed;
+  }
+
+  auto moveDelta = ship.linearVelocity * static_cast<float>(dt.GetSeconds());
+  move(ship.transform, moveDelta);
+}
+
+static void updateBulletMovement(LevelState& state, ezTime dt)
+{
+  auto moveDelta = state.bullet.linearVelocity * static_cast<float>(dt.GetSeconds());
+  move(state.bullet.transform, moveDelta);
+}
+
+static void destroy(LevelState& state, Asteroid& asteroid)
+{
+  --asteroid.lives;
+
+  if (asteroid.lives < 1)
+  {
+    return;
+  }
+
+  const auto degrees = 45.0f;
+
+  asteroid.boundingRadius -= Asteroid::RadiusLossPerLife;
+
+  asteroid.linearVelocity = asteroid.linearVelocity.GetLength() * state.bullet.linearVelocity.GetNormalized();
+  rotate(asteroid.linearVelocity, ezAngle::Degree(degrees));
+
+  auto other = asteroid;
+  rotate(other.linearVelocity, ezAngle::Degree(-2.0f * degrees));
+  addAsteroid(state.world, other);
+}
+
+void initialize(LevelState& state, const SimulationDesc& desc)
+{
+  state.random = RandomEngine(desc.seed);
+
+  state.view = desc.viewBounds;
+  state.viewFollowsShip = desc.chunkSize > 0.0f;
+  state.activeMargin = desc.chunkSize;
+
+  state.ship.transform = Transform2D::zero();
+  state.ship.linearVelocity.SetZero();
+  state.ship.boundingRadius = desc.shipRadius;
+  state.ship.lives = Ship::NumLives;
+  state.ship.invulnerable = false;
+
+  state.bullet.boundingRadius = desc.bulletRadius;
+  state.bullet.alive = false;
+
+  state.timers.clear();
+  state.ship.invulnerableTimer.invalidate();
+  state.bullet.lifeTimer.invalidate();
+
+  initialize(state.world, desc.worldBounds, desc.chunkSize);
+  state.world.asteroidsPerChunk = desc.asteroidsPerChunk;
+  state.world.asteroidRadius = desc.asteroidRadius;
+  state.world.minAsteroidSpeed = desc.minAsteroidSpeed;
+  state.world.maxAsteroidSpeed = desc.maxAsteroidSpeed;
+  state.world.seed = static_cast<ezUInt32>(desc.seed);
+
+  respawn(state, desc.numInitialAsteroids);
+}
+
+void respawn(LevelState& state, ezUInt32 numAsteroids)
+{
+  state.ship.transform = Transform2D::zero();
+  state.ship.linearVelocity.SetZero();
+
+  killBullet(state);
+
+  reset(state.world);
+  updateView(state);
+
+  AsteroidFieldDesc field;
+  field.bounds = state.view;
+  field.numAsteroids = numAsteroids;
+  field.radius = state.world.asteroidRadius;
+  field.minSpeed = state.world.minAsteroidSpeed;
+  field.maxSpeed = state.world.maxAsteroidSpeed;
+  field.keepOutCenter = state.ship.transform.position;
+  field.keepOutRadius = state.ship.boundingRadius;
+  auto seedHigh = static_cast<ezUInt64>(state.random());
+  auto seedLow = static_cast<ezUInt64>(state.random());
+  field.seed = (seedHigh << 32) | seedLow;
+
+  ezDynamicArray<Asteroid> asteroids;
+  generateAsteroidField(field, asteroids);
+  for (const auto& a : asteroids)
+  {
+    addAsteroid(state.world, a);
+  }
+}
+
+void updateView(LevelState& state)
+{
+  if (state.viewFollowsShip)
+  {
+    const auto& center = state.ship.transform.position;
+    state.view.x = center.x - 0.5f * state.view.width;
+    state.view.y = center.y - 0.5f * state.view.height;
+  }
+
+  auto activeArea = state.view;
+  activeArea.x -= state.activeMargin;
+  activeArea.y -= state.activeMargin;
+  activeArea.width += 2.0f * state.activeMargin;
+  activeArea.height += 2.0f * state.activeMargin;
+  activate(state.world, activeArea, state.view);
+}
+
+LevelStepResult step(LevelState& state, const LevelInput& input, ezTime dt)
+{
+  LevelStepResult result;
+
+  // Worlds that stream in asteroids never run out of them.
+  if(state.world.asteroidsPerChunk == 0 && countLiveAsteroids(state.world) == 0)
+  {
+    result.allAsteroidsDestroyed = true;
+    return result;
+  }
+
+  state.timers.advance(dt, [&state](ezArrayPtr<LevelEvent> events)
+  {
+    handleTimedEvents(state, events);
+  });
+
+  if (input.shoot
+      && !state.bullet.isAlive()
+      && !state.ship.isInvulnerable())
+  {
+    spawnBullet(state);
+  }
+
+  // Update Movement/Rotation
+  // ========================
+
+  // Ship
+  updateShipRotation(state, input, dt);
+  updateShipMovement(state, input, dt);
+
+  // Bullet
+  updateBulletMovement(state, dt);
+
+  // Asteroids
+  update(state.world, dt);
+
+  // Level Bounds Checking
+  // =====================
+
+  // Ship
+  levelBoundsCheck(state, spatialData(state.ship));
+
+  // Bullet
+  levelBoundsCheck(state, spatialData(state.bullet));
+
+  // Level Streaming
+  // ===============
+  updateView(state);
+
+  // Collision With Bullet
+  // =====================
+  if (state.bullet.isAlive())
+  {
+    auto bulletSpacial = spatialData(state.bullet);
+    for (auto chunkIndex : state.world.activeChunks)
+    {
+      for (auto& a : state.world.chunks[chunkIndex].asteroids)
+      {
+        if(!a.isAlive())
+        {
+          continue;
+        }
+
+        if (areColliding(bulletSpacial, spatialData(a)))
+        {
+          // Check before destroy, which may add an asteroid to this chunk and invalidate `a`.
+          if (a.lives <= 1)
+          {
+            ++result.numAsteroidsDestroyed;
+          }
+          destroy(state, a);
+          killBullet(state);
+          ++result.numAsteroidHits;
+          break;
+        }
+      }
+
+      if (!state.bullet.isAlive())
+      {
+        break;
+      }
+    }
+  }
+
+  // Collision With Ship
+  // ===================
+  if (!state.ship.isInvulnerable())
+  {
+    auto shipSpacial = spatialData(state.ship);
+    for (auto chunkIndex : state.world.activeChunks)
+    {
+      for(auto& a : state.world.chunks[chunkIndex].asteroids)
+      {
+        if(!a.isAlive())
+        {
+          continue;
+        }
+
+        if(areColliding(shipSpacial, spatialData(a)))
+        {
+          --state.ship.lives;
+          makeShipInvulnerable(state);
+          ++result.numShipHits;
+        }
+      }
+    }
+  }
+
+  result.shipDestroyed = state.ship.lives < 1;
+  return result;
+}
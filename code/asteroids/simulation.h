@@ -0,0 +1,57 @@
+#pragma once
+
+#include <asteroids/levelState.h>
+
+/// \brief Player input for a single simulation step.
+struct LevelInput
+{
+  float thrust = 0.0f; ///< From 0 to 1.
+  float turn = 0.0f;   ///< From -1 (clockwise) to 1 (counter-clockwise).
+  bool shoot = false;
+};
+
+/// \brief What happened during a single simulation step.
+struct LevelStepResult
+{
+  ezUInt32 numShipHits = 0;
+  ezUInt32 numAsteroidHits = 0;
+  ezUInt32 numAsteroidsDestroyed = 0; ///< Asteroid hits that took the last life of the asteroid.
+  bool shipDestroyed = false;
+  bool allAsteroidsDestroyed = false;
+};
+
+/// \brief Everything needed to set up a LevelState without any rendering resources.
+struct SimulationDesc
+{
+  ezRectFloat viewBounds;  ///< Initial asteroids are placed in here.
+  ezRectFloat worldBounds;
+  float chunkSize = 0.0f;
+  ezUInt32 asteroidsPerChunk = 0;
+  ezUInt32 numInitialAsteroids = 3;
+
+  float shipRadius = 19.2f;
+  float bulletRadius = 4.0f;
+  float asteroidRadius = 32.0f;
+  float minAsteroidSpeed = Asteroid::MinSpeed;
+  float maxAsteroidSpeed = Asteroid::MaxSpeed;
+
+  ezUInt64 seed = 0;
+};
+
+void initialize(LevelState& state, const SimulationDesc& desc);
+
+/// \brief Puts the ship back to the origin and replaces all asteroids with \a numAsteroids new ones in view.
+///
+/// The new asteroids don't overlap each other or the ship. If the view is too
+/// crowded for that, fewer asteroids are placed.
+void respawn(LevelState& state, ezUInt32 numAsteroids);
+
+/// \brief Advances \a state by \a dt.
+///
+/// The result only depends on the arguments, so given the same state, input and
+/// time step the outcome is always the same. Once the state has reached its
+/// typical size, a step does not allocate any memory.
+LevelStepResult step(LevelState& state, const LevelInput& input, ezTime dt);
+
+/// \brief Moves the view along with the ship and activates the chunks around it.
+void updateView(LevelState& state);
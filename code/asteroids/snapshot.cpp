@@ -0,0 +1,506 @@
+#include <asteroids/snapshot.h>
+
+#include <cmath>
+
+using namespace kr;
+
+static_assert(sizeof(SnapshotHeader) == 32, "Snapshot layout changed, bump SnapshotHeader::CurrentVersion.");
+static_assert(sizeof(SnapshotLevel) == 144, "Snapshot layout changed, bump SnapshotHeader::CurrentVersion.");
+static_assert(sizeof(SnapshotChunk) == 32, "Snapshot layout changed, bump SnapshotHeader::CurrentVersion.");
+static_assert(sizeof(SnapshotTimer) == 16, "Snapshot layout changed, bump SnapshotHeader::CurrentVersion.");
+static_assert(sizeof(SnapshotAsteroid) == 28, "Snapshot layout changed, bump SnapshotHeader::CurrentVersion.");
+
+static SnapshotBody toSnapshot(const Transform2D& transform, const ezVec2& linearVelocity, float boundingRadius)
+{
+  SnapshotBody body;
+  body.positionX = transform.position.x;
+  body.positionY = transform.position.y;
+  body.rotation = transform.rotation.GetRadian();
+  body.velocityX = linearVelocity.x;
+  body.velocityY = linearVelocity.y;
+  body.boundingRadius = boundingRadius;
+  return body;
+}
+
+static void fromSnapshot(const SnapshotBody& body, Transform2D& transform, ezVec2& linearVelocity, float& boundingRadius)
+{
+  transform.position.Set(body.positionX, body.positionY);
+  transform.rotation = ezAngle::Radian(body.rotation);
+  linearVelocity.Set(body.velocityX, body.velocityY);
+  boundingRadius = body.boundingRadius;
+}
+
+/// \brief Collects records and hands them to the stream in batches.
+template<typename RECORD>
+class BatchedWriter
+{
+public:
+  explicit BatchedWriter(ezStreamWriterBase& writer) : writer(writer) {}
+
+  void add(const RECORD& record)
+  {
+    this->batch[this->count++] = record;
+    if(this->count == BatchSize)
+    {
+      this->flush();
+    }
+  }
+
+  ezResult flush()
+  {
+    if(this->count > 0 && this->result.Succeeded())
+    {
+      this->result = this->writer.WriteBytes(this->batch, this->count * sizeof(RECORD));
+    }
+    this->count = 0;
+    return this->result;
+  }
+
+private:
+  enum { BatchSize = 256 };
+
+  ezStreamWriterBase& writer;
+  RECORD batch[BatchSize];
+  ezUInt32 count = 0;
+  ezResult result = EZ_SUCCESS;
+};
+
+ezResult writeSnapshot(const LevelState& state, ezStreamWriterBase& writer)
+{
+  const auto& world = state.world;
+
+  ezUInt32 numAsteroids = 0;
+  for(const auto& chunk : world.chunks)
+  {
+    numAsteroids += chunk.asteroids.GetCount();
+  }
+
+  // Header
+  // ======
+  SnapshotHeader header;
+  header.magic = SnapshotHeader::Magic;
+  header.version = SnapshotHeader::CurrentVersion;
+  header.numChunks = world.chunks.GetCount();
+  header.numTimers = state.timers.getNumPending();
+  header.numAsteroids = numAsteroids;
+  header.padding = 0;
+  header.totalSize = sizeof(SnapshotHeader)
+                   + sizeof(SnapshotLevel)
+                   + header.numChunks * sizeof(SnapshotChunk)
+                   + header.numTimers * sizeof(SnapshotTimer)
+                   + header.numAsteroids * sizeof(SnapshotAsteroid);
+
+  if(writer.WriteBytes(&header, sizeof(header)).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  // Level
+  // =====
+  SnapshotLevel level;
+  level.ship = toSnapshot(state.ship.transform, state.ship.linearVelocity, state.ship.boundingRadius);
+  level.bullet = toSnapshot(state.bullet.transform, state.bullet.linearVelocity, state.bullet.boundingRadius);
+  level.shipLives = state.ship.lives;
+  level.flags = 0;
+  if(state.ship.isInvulnerable()) { level.flags |= SnapshotLevel::ShipInvulnerable; }
+  if(state.bullet.isAlive())      { level.flags |= SnapshotLevel::BulletAlive; }
+
+  level.worldX = world.bounds.x;
+  level.worldY = world.bounds.y;
+  level.worldWidth = world.bounds.width;
+  level.worldHeight = world.bounds.height;
+  level.chunkWidth = world.chunkWidth;
+  level.chunkHeight = world.chunkHeight;
+  level.numChunksX = world.numChunksX;
+  level.numChunksY = world.numChunksY;
+  level.asteroidsPerChunk = world.asteroidsPerChunk;
+  level.asteroidRadius = world.asteroidRadius;
+  level.worldSeed = world.seed;
+  level.padding = 0;
+  level.worldTime = world.time.GetSeconds();
+
+  level.randomState = state.random.state;
+
+  level.timerTick = state.timers.getCurrentTick();
+  level.timerAccumulatedTime = state.timers.getAccumulatedTime().GetSeconds();
+  level.timerTickDuration = state.timers.getTickDuration().GetSeconds();
+
+  if(writer.WriteBytes(&level, sizeof(level)).Failed())
+  {
+    return EZ_FAILURE;
+  }
+
+  // Chunks
+  // ======
+  {
+    ezDynamicArray<ezUInt32> activeIndices;
+    activeIndices.SetCount(world.chunks.GetCount());
+    for(auto& index : activeIndices)
+    {
+      index = SnapshotChunk::NotActive;
+    }
+    for(ezUInt32 i = 0; i < world.activeChunks.GetCount(); ++i)
+    {
+      activeIndices[world.activeChunks[i]] = i;
+    }
+
+    BatchedWriter<SnapshotChunk> chunks(writer);
+    ezUInt32 firstAsteroid = 0;
+    for(ezUInt32 i = 0; i < world.chunks.GetCount(); ++i)
+    {
+      const auto& chunk = world.chunks[i];
+      SnapshotChunk record;
+      record.x = chunk.x;
+      record.y = chunk.y;
+      record.firstAsteroid = firstAsteroid;
+      record.numAsteroids = chunk.asteroids.GetCount();
+      record.lastUpdate = chunk.lastUpdate.GetSeconds();
+      record.flags = 0;
+      if(chunk.isActive)    { record.flags |= SnapshotChunk::Active; }
+      if(chunk.isPopulated) { record.flags |= SnapshotChunk::Populated; }
+      record.activeIndex = activeIndices[i];
+      chunks.add(record);
+
+      firstAsteroid += record.numAsteroids;
+    }
+
+    if(chunks.flush().Failed())
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  // Timers
+  // ======
+  {
+    BatchedWriter<SnapshotTimer> timers(writer);
+    state.timers.forEachPending([&timers](ezUInt64 dueTick, const LevelEvent& e)
+    {
+      SnapshotTimer record;
+      record.dueTick = dueTick;
+      record.type = e.type;
+      record.padding = 0;
+      timers.add(record);
+    });
+
+    if(timers.flush().Failed())
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  // Asteroids
+  // =========
+  {
+    BatchedWriter<SnapshotAsteroid> asteroids(writer);
+    for(const auto& chunk : world.chunks)
+    {
+      for(const auto& a : chunk.asteroids)
+      {
+        SnapshotAsteroid record;
+        record.body = toSnapshot(a.transform, a.linearVelocity, a.boundingRadius);
+        record.lives = a.lives;
+        asteroids.add(record);
+      }
+    }
+
+    if(asteroids.flush().Failed())
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+static bool isFinite(float value)
+{
+  return std::isfinite(value);
+}
+
+static bool isFinite(double value)
+{
+  return std::isfinite(value);
+}
+
+static bool isFinite(const SnapshotBody& body)
+{
+  return isFinite(body.positionX) && isFinite(body.positionY) && isFinite(body.rotation)
+      && isFinite(body.velocityX) && isFinite(body.velocityY) && isFinite(body.boundingRadius);
+}
+
+/// \brief Whether \a numChunks is what initialize(World&, ...) computes for the given extents.
+static bool isValidChunkCount(float extent, float chunkExtent, ezInt32 numChunks)
+{
+  if(!isFinite(extent) || !isFinite(chunkExtent) || extent <= 0.0f || chunkExtent <= 0.0f)
+  {
+    return false;
+  }
+
+  auto count = static_cast<double>(std::ceil(extent / chunkExtent));
+  if(count > 0x7FFFFFFF)
+  {
+    return false;
+  }
+
+  return numChunks == ezMath::Max(1, static_cast<ezInt32>(count));
+}
+
+template<typename RECORD>
+static ezArrayPtr<const RECORD> recordsAt(const ezUInt8* data, ezUInt64& offset, ezUInt32 count)
+{
+  auto records = ezArrayPtr<const RECORD>(reinterpret_cast<const RECORD*>(data + offset), count);
+  offset += count * sizeof(RECORD);
+  return records;
+}
+
+ezResult viewSnapshot(ezArrayPtr<const ezUInt8> bytes, SnapshotView& view)
+{
+  view = SnapshotView();
+
+  if(bytes.GetCount() < sizeof(SnapshotHeader) + sizeof(SnapshotLevel))
+  {
+    ezLog::Error("Snapshot is too small (%u bytes).", bytes.GetCount());
+    return EZ_FAILURE;
+  }
+
+  const auto* data = bytes.GetPtr();
+  if(reinterpret_cast<size_t>(data) % 8 != 0)
+  {
+    ezLog::Error("Snapshot data is not 8 byte aligned.");
+    return EZ_FAILURE;
+  }
+
+  const auto* header = reinterpret_cast<const SnapshotHeader*>(data);
+  if(header->magic != SnapshotHeader::Magic)
+  {
+    ezLog::Error("Data is not a snapshot.");
+    return EZ_FAILURE;
+  }
+
+  if(header->version != SnapshotHeader::CurrentVersion)
+  {
+    ezLog::Error("Unsupported snapshot version %u, expected %u.", header->version, SnapshotHeader::CurrentVersion);
+    return EZ_FAILURE;
+  }
+
+  auto expectedSize = sizeof(SnapshotHeader)
+                    + sizeof(SnapshotLevel)
+                    + ezUInt64(header->numChunks) * sizeof(SnapshotChunk)
+                    + ezUInt64(header->numTimers) * sizeof(SnapshotTimer)
+                    + ezUInt64(header->numAsteroids) * sizeof(SnapshotAsteroid);
+  if(header->totalSize != expectedSize || bytes.GetCount() < expectedSize)
+  {
+    ezLog::Error("Snapshot is truncated or corrupt.");
+    return EZ_FAILURE;
+  }
+
+  ezUInt64 offset = sizeof(SnapshotHeader);
+  view.header = header;
+  view.level = reinterpret_cast<const SnapshotLevel*>(data + offset);
+  offset += sizeof(SnapshotLevel);
+  view.chunks = recordsAt<SnapshotChunk>(data, offset, header->numChunks);
+  view.timers = recordsAt<SnapshotTimer>(data, offset, header->numTimers);
+  view.asteroids = recordsAt<SnapshotAsteroid>(data, offset, header->numAsteroids);
+
+  // World
+  // =====
+  // Everything chunk coordinates are computed from, so restoring never divides
+  // by zero or converts a non-finite value to an integer.
+  const auto& level = *view.level;
+  auto numChunkCoords = ezInt64(level.numChunksX) * level.numChunksY;
+  if(!isFinite(level.worldX) || !isFinite(level.worldY)
+     || !isValidChunkCount(level.worldWidth, level.chunkWidth, level.numChunksX)
+     || !isValidChunkCount(level.worldHeight, level.chunkHeight, level.numChunksY)
+     || numChunkCoords < header->numChunks
+     || !isFinite(level.worldTime)
+     || !isFinite(level.ship) || !isFinite(level.bullet))
+  {
+    ezLog::Error("Snapshot world is corrupt.");
+    view = SnapshotView();
+    return EZ_FAILURE;
+  }
+
+  // The timing wheel divides by the tick duration and converts whole ticks to integers.
+  if(!isFinite(level.timerTickDuration) || level.timerTickDuration <= 0.0
+     || !isFinite(level.timerAccumulatedTime) || level.timerAccumulatedTime < 0.0
+     || level.timerAccumulatedTime >= level.timerTickDuration)
+  {
+    ezLog::Error("Snapshot timers are corrupt.");
+    view = SnapshotView();
+    return EZ_FAILURE;
+  }
+
+  // Chunks
+  // ======
+  ezUInt32 numActive = 0;
+  for(const auto& chunk : view.chunks)
+  {
+    if(chunk.flags & SnapshotChunk::Active)
+    {
+      ++numActive;
+    }
+  }
+
+  ezDynamicArray<ezUInt8> isActiveIndexUsed;
+  isActiveIndexUsed.SetCount(numActive);
+  for(auto& used : isActiveIndexUsed)
+  {
+    used = 0;
+  }
+
+  // Two records for the same coordinates would leave one of them unreachable through the lookup.
+  ezHashTable<ezUInt64, ezUInt32> chunkAtCoord;
+  chunkAtCoord.Reserve(view.chunks.GetCount());
+
+  for(ezUInt32 i = 0; i < view.chunks.GetCount(); ++i)
+  {
+    const auto& chunk = view.chunks[i];
+    const auto isActive = (chunk.flags & SnapshotChunk::Active) != 0;
+    const auto hasValidActiveIndex = isActive
+      ? chunk.activeIndex < numActive && !isActiveIndexUsed[chunk.activeIndex]
+      : chunk.activeIndex == SnapshotChunk::NotActive;
+
+    if(ezUInt64(chunk.firstAsteroid) + chunk.numAsteroids > header->numAsteroids
+       || chunk.x < 0 || chunk.x >= level.numChunksX
+       || chunk.y < 0 || chunk.y >= level.numChunksY
+       || !isFinite(chunk.lastUpdate)
+       || !hasValidActiveIndex
+       || chunkAtCoord.Insert(chunkKey(chunk.x, chunk.y), i))
+    {
+      ezLog::Error("Snapshot chunk %u is corrupt.", i);
+      view = SnapshotView();
+      return EZ_FAILURE;
+    }
+
+    if(isActive)
+    {
+      isActiveIndexUsed[chunk.activeIndex] = 1;
+    }
+  }
+
+  for(ezUInt32 i = 0; i < view.timers.GetCount(); ++i)
+  {
+    auto type = view.timers[i].type;
+    if(type != LevelEvent::BulletExpired && type != LevelEvent::ShipVulnerable)
+    {
+      ezLog::Error("Snapshot timer %u has unknown type %u.", i, type);
+      view = SnapshotView();
+      return EZ_FAILURE;
+    }
+  }
+
+  for(ezUInt32 i = 0; i < view.asteroids.GetCount(); ++i)
+  {
+    auto lives = view.asteroids[i].lives;
+    if(lives < 0 || lives > Asteroid::NumLives || !isFinite(view.asteroids[i].body))
+    {
+      ezLog::Error("Snapshot asteroid %u is corrupt.", i);
+      view = SnapshotView();
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+void restoreSnapshot(const SnapshotView& view, LevelState& state)
+{
+  const auto& level = *view.level;
+
+  // Ship And Bullet
+  // ===============
+  fromSnapshot(level.ship, state.ship.transform, state.ship.linearVelocity, state.ship.boundingRadius);
+  state.ship.lives = level.shipLives;
+  state.ship.invulnerable = (level.flags & SnapshotLevel::ShipInvulnerable) != 0;
+  state.ship.invulnerableTimer.invalidate();
+
+  fromSnapshot(level.bullet, state.bullet.transform, state.bullet.linearVelocity, state.bullet.boundingRadius);
+  state.bullet.alive = (level.flags & SnapshotLevel::BulletAlive) != 0;
+  state.bullet.lifeTimer.invalidate();
+
+  // World
+  // =====
+  auto& world = state.world;
+  world.bounds = ezRectFloat(level.worldX, level.worldY, level.worldWidth, level.worldHeight);
+  world.chunkWidth = level.chunkWidth;
+  world.chunkHeight = level.chunkHeight;
+  world.numChunksX = level.numChunksX;
+  world.numChunksY = level.numChunksY;
+  world.asteroidsPerChunk = level.asteroidsPerChunk;
+  world.asteroidRadius = level.asteroidRadius;
+  world.seed = level.worldSeed;
+  world.time = ezTime::Seconds(level.worldTime);
+  reset(world);
+
+  world.chunks.SetCount(view.chunks.GetCount());
+  world.chunkLookup.Reserve(view.chunks.GetCount());
+
+  ezUInt32 numActive = 0;
+  for(const auto& record : view.chunks)
+  {
+    if(record.activeIndex != SnapshotChunk::NotActive)
+    {
+      ++numActive;
+    }
+  }
+  world.activeChunks.SetCount(numActive);
+
+  for(ezUInt32 i = 0; i < view.chunks.GetCount(); ++i)
+  {
+    const auto& record = view.chunks[i];
+    auto& chunk = world.chunks[i];
+    chunk.x = record.x;
+    chunk.y = record.y;
+    chunk.bounds = chunkBounds(world, record.x, record.y);
+    chunk.lastUpdate = ezTime::Seconds(record.lastUpdate);
+    chunk.isActive = (record.flags & SnapshotChunk::Active) != 0;
+    chunk.isPopulated = (record.flags & SnapshotChunk::Populated) != 0;
+
+    chunk.asteroids.SetCount(record.numAsteroids);
+    for(ezUInt32 j = 0; j < record.numAsteroids; ++j)
+    {
+      const auto& asteroidRecord = view.asteroids[record.firstAsteroid + j];
+      auto& a = chunk.asteroids[j];
+      fromSnapshot(asteroidRecord.body, a.transform, a.linearVelocity, a.boundingRadius);
+      a.lives = asteroidRecord.lives;
+    }
+
+    world.chunkLookup.Insert(chunkKey(record.x, record.y), i);
+    if(chunk.isActive)
+    {
+      world.activeChunks[record.activeIndex] = i;
+    }
+  }
+
+  // Timers
+  // ======
+  auto tickDuration = ezTime::Seconds(level.timerTickDuration);
+  if(state.timers.getTickDuration() != tickDuration)
+  {
+    state.timers = TimingWheel<LevelEvent>(tickDuration);
+  }
+  state.timers.clear(level.timerTick, ezTime::Seconds(level.timerAccumulatedTime));
+
+  for(ezUInt32 i = 0; i < view.timers.GetCount(); ++i)
+  {
+    const auto& record = view.timers[i];
+    LevelEvent e;
+    e.type = static_cast<LevelEvent::Type>(record.type);
+    auto handle = state.timers.scheduleAtTick(record.dueTick, e);
+
+    switch(e.type)
+    {
+    case LevelEvent::BulletExpired:
+      state.bullet.lifeTimer = handle;
+      break;
+    case LevelEvent::ShipVulnerable:
+      state.ship.invulnerableTimer = handle;
+      break;
+    }
+  }
+
+  // Random
+  // ======
+  state.random.state = level.randomState;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <asteroids/levelState.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Types/ArrayPtr.h>
+
+/// \file
+/// Versioned binary snapshots of a LevelState.
+///
+/// A snapshot is laid out as
+///   SnapshotHeader
+///   SnapshotLevel
+///   SnapshotChunk[numChunks]
+///   SnapshotTimer[numTimers]
+///   SnapshotAsteroid[numAsteroids]
+/// All records have a fixed size, are naturally aligned and use the native byte
+/// order, so a snapshot can be viewed in place wherever its bytes are, e.g. in a
+/// memory mapped file. Tuning values like Ship::maxSpeed are not part of a snapshot.
+///
+/// To clone a level in memory, simply copy the LevelState.
+
+struct SnapshotHeader
+{
+  enum : ezUInt32 { Magic = 0x504E5341, CurrentVersion = 2 }; // "ASNP"
+
+  ezUInt32 magic;
+  ezUInt32 version;
+  ezUInt64 totalSize;
+  ezUInt32 numChunks;
+  ezUInt32 numTimers;
+  ezUInt32 numAsteroids;
+  ezUInt32 padding;
+};
+
+struct SnapshotBody
+{
+  float positionX;
+  float positionY;
+  float rotation; ///< Radians.
+  float velocityX;
+  float velocityY;
+  float boundingRadius;
+};
+
+struct SnapshotLevel
+{
+  enum : ezUInt32 { ShipInvulnerable = 1 << 0, BulletAlive = 1 << 1 };
+
+  SnapshotBody ship;
+  SnapshotBody bullet;
+  ezInt32 shipLives;
+  ezUInt32 flags;
+
+  float worldX;
+  float worldY;
+  float worldWidth;
+  float worldHeight;
+  float chunkWidth;
+  float chunkHeight;
+  ezInt32 numChunksX;
+  ezInt32 numChunksY;
+  ezUInt32 asteroidsPerChunk;
+  float asteroidRadius;
+  ezUInt32 worldSeed;
+  ezUInt32 padding;
+  double worldTime;
+
+  ezUInt64 randomState;
+
+  ezUInt64 timerTick;
+  double timerAccumulatedTime;
+  double timerTickDuration;
+};
+
+struct SnapshotChunk
+{
+  enum : ezUInt32 { Active = 1 << 0, Populated = 1 << 1 };
+  enum : ezUInt32 { NotActive = 0xFFFFFFFFu };
+
+  ezInt32 x;
+  ezInt32 y;
+  ezUInt32 firstAsteroid;
+  ezUInt32 numAsteroids;
+  double lastUpdate;
+  ezUInt32 flags;
+
+  /// Position in World::activeChunks, or NotActive. The simulation visits active
+  /// chunks in that order, so it has to be restored for a level to play out the same.
+  ezUInt32 activeIndex;
+};
+
+struct SnapshotTimer
+{
+  ezUInt64 dueTick;
+  ezUInt32 type; ///< LevelEvent::Type
+  ezUInt32 padding;
+};
+
+struct SnapshotAsteroid
+{
+  SnapshotBody body;
+  ezInt32 lives;
+};
+
+/// \brief Read-only view of the records of a snapshot, pointing into the snapshot bytes.
+struct SnapshotView
+{
+  const SnapshotHeader* header = nullptr;
+  const SnapshotLevel* level = nullptr;
+  ezArrayPtr<const SnapshotChunk> chunks;
+  ezArrayPtr<const SnapshotTimer> timers;
+  ezArrayPtr<const SnapshotAsteroid> asteroids;
+};
+
+/// \brief Streams a snapshot of \a state to \a writer without building it in memory first.
+ezResult writeSnapshot(const LevelState& state, ezStreamWriterBase& writer);
+
+/// \brief Validates \a bytes and sets up \a view to point into them. Nothing is copied.
+///
+/// \a bytes must be 8 byte aligned and stay alive as long as \a view is used.
+ezResult viewSnapshot(ezArrayPtr<const ezUInt8> bytes, SnapshotView& view);
+
+/// \brief Overwrites \a state with the content of a snapshot.
+void restoreSnapshot(const SnapshotView& view, LevelState& state);
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <Foundation/Time/Time.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Types/ArrayPtr.h>
+
+#include <cmath>
+
+/// \brief Refers to an event scheduled in a TimingWheel.
+///
+/// Handles stay safe to use after the event fired or was cancelled;
+/// they simply stop being pending.
+struct TimerHandle
+{
+  enum : ezUInt32 { InvalidIndex = 0xFFFFFFFFu };
+
+  ezUInt32 index = InvalidIndex;
+  ezUInt32 generation = 0;
+
+  bool isValid() const { return this->index != InvalidIndex; }
+  void invalidate() { this->index = InvalidIndex; }
+};
+
+/// \brief Hierarchical timing wheel that fires typed events in batches.
+///
+/// Time is quantized into ticks of \a tickDuration. Each level has 256 slots,
+/// level N covering 256^(N+1) ticks, so scheduling and cancelling is O(1) and
+/// advancing only touches the slot of the current tick (plus the occasional
+/// cascade of a higher level slot). Runs of ticks without anything to do are
+/// skipped entirely. Nothing is scanned per frame.
+///
+/// The wheel is a plain value type without any dependency on rendering or
+/// input, so it can be copied along with the state that owns it.
+template<typename DATA>
+class TimingWheel
+{
+public:
+  enum
+  {
+    LevelBits = 8,
+    NumSlotsPerLevel = 1 << LevelBits,
+    NumLevels = 4,
+  };
+
+  explicit TimingWheel(ezTime tickDuration = ezTime::Milliseconds(1))
+  {
+    this->tickDuration = tickDuration;
+    this->clear();
+  }
+
+  /// \brief Schedules \a data to be fired once \a delay has passed.
+  ///
+  /// The event fires on the first tick boundary at or after the delay, but
+  /// never in the same tick it was scheduled in. Delays are clamped to
+  /// 2^32 - 1 ticks (~49 days at 1ms per tick).
+  TimerHandle schedule(ezTime delay, const DATA& data)
+  {
+    const auto maxTicks = static_cast<double>((ezUInt64(1) << (LevelBits * NumLevels)) - 1);
+    auto ticks = std::ceil((this->accumulatedTime + delay).GetSeconds() / this->tickDuration.GetSeconds());
+    auto numTicks = static_cast<ezUInt64>(ezMath::Clamp(ticks, 1.0, maxTicks));
+    return this->scheduleAtTick(this->currentTick + numTicks, data);
+  }
+
+  /// \brief Schedules \a data to be fired at an absolute tick, e.g. to restore saved events.
+  ///
+  /// Ticks that are not in the future are moved to the next tick.
+  TimerHandle scheduleAtTick(ezUInt64 dueTick, const DATA& data)
+  {
+    auto index = this->allocateNode();
+    auto& node = this->nodes[index];
+    node.data = data;
+    node.dueTick = dueTick > this->currentTick ? dueTick : this->currentTick + 1;
+    this->link(index);
+    ++this->numPending;
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = node.generation;
+    return handle;
+  }
+
+  /// \brief Removes a pending event without firing it and invalidates \a handle.
+  /// \return \c false if the event already fired or was cancelled before.
+  bool cancel(TimerHandle& handle)
+  {
+    if(!this->isPending(handle))
+    {
+      handle.invalidate();
+      return false;
+    }
+
+    this->unlink(handle.index);
+    this->freeNode(handle.index);
+    --this->numPending;
+    handle.invalidate();
+    return true;
+  }
+
+  bool isPending(TimerHandle handle) const
+  {
+    if(!handle.isValid() || handle.index >= this->nodes.GetCount())
+    {
+      return false;
+    }
+
+    const auto& node = this->nodes[handle.index];
+    return node.slot != InvalidIndex && node.generation == handle.generation;
+  }
+
+  /// \brief Time left until the event of \a handle fires, or zero if it is not pending.
+  ezTime getRemainingTime(TimerHandle handle) const
+  {
+    if(!this->isPending(handle))
+    {
+      return ezTime();
+    }
+
+    auto ticks = this->nodes[handle.index].dueTick - this->currentTick;
+    return this->tickDuration * static_cast<double>(ticks) - this->accumulatedTime;
+  }
+
+  /// \brief Calls \a func(dueTick, data) for each pending event, in no particular order.
+  template<typename FUNC>
+  void forEachPending(FUNC&& func) const
+  {
+    for(const auto& node : this->nodes)
+    {
+      if(node.slot != InvalidIndex)
+      {
+        func(node.dueTick, node.data);
+      }
+    }
+  }
+
+  /// \brief Drops all pending events without firing them and starts over at tick 0.
+  void clear()
+  {
+    this->clear(0, ezTime());
+  }
+
+  /// \brief Drops all pending events without firing them and sets the current time.
+  void clear(ezUInt64 currentTick, ezTime accumulatedTime)
+  {
+    for(auto& head : this->slots)
+    {
+      head = InvalidIndex;
+    }
+    for(auto& count : this->levelCounts)
+    {
+      count = 0;
+    }
+    this->nodes.Clear();
+    this->freeList = InvalidIndex;
+    this->numPending = 0;
+    this->currentTick = currentTick;
+    this->accumulatedTime = accumulatedTime;
+  }
+
+  /// \brief Moves time forward by \a dt and fires all events that became due.
+  ///
+  /// \a handler is called once per tick that has expired events, with all of
+  /// them as an ezArrayPtr<DATA>. Events may be scheduled or cancelled from
+  /// within the handler, but advance() must not be called recursively.
+  template<typename HANDLER>
+  void advance(ezTime dt, HANDLER&& handler)
+  {
+    this->accumulatedTime += dt;
+
+    auto ticks = std::floor(this->accumulatedTime.GetSeconds() / this->tickDuration.GetSeconds());
+    if(ticks < 1.0)
+    {
+      return;
+    }
+    this->accumulatedTime -= this->tickDuration * ticks;
+
+    auto targetTick = this->currentTick + static_cast<ezUInt64>(ticks);
+    while(this->currentTick < targetTick)
+    {
+      // Jump over ticks in which nothing can cascade or fire.
+      auto nextTick = this->getNextEventfulTick();
+      if(nextTick > targetTick)
+      {
+        this->currentTick = targetTick;
+        break;
+      }
+
+      this->currentTick = nextTick - 1;
+      this->tick(handler);
+    }
+  }
+
+  ezUInt32 getNumPending() const { return this->numPending; }
+  ezUInt64 getCurrentTick() const { return this->currentTick; }
+  ezTime getAccumulatedTime() const { return this->accumulatedTime; }
+  ezTime getTickDuration() const { return this->tickDuration; }
+
+private:
+  enum : ezUInt32 { InvalidIndex = TimerHandle::InvalidIndex };
+
+  struct Node
+  {
+    DATA data;
+    ezUInt64 dueTick = 0;
+    ezUInt32 prev = InvalidIndex;
+    ezUInt32 next = InvalidIndex; ///< Also links the free list.
+    ezUInt32 slot = InvalidIndex; ///< InvalidIndex while the node is free.
+    ezUInt32 generation = 0;
+  };
+
+  ezUInt32 allocateNode()
+  {
+    if(this->freeList == InvalidIndex)
+    {
+      this->nodes.ExpandAndGetRef();
+      return this->nodes.GetCount() - 1;
+    }
+
+    auto index = this->freeList;
+    this->freeList = this->nodes[index].next;
+    return index;
+  }
+
+  void freeNode(ezUInt32 index)
+  {
+    auto& node = this->nodes[index];
+    node.slot = InvalidIndex;
+    node.prev = InvalidIndex;
+    node.next = this->freeList;
+    ++node.generation;
+    this->freeList = index;
+  }
+
+  /// The level is chosen by the highest tick digit in which the due tick
+  /// differs from the current tick, so each slot is cascaded exactly when
+  /// the lower digits roll over to its time span.
+  void link(ezUInt32 index)
+  {
+    auto& node = this->nodes[index];
+    auto diff = node.dueTick ^ this->currentTick;
+
+    ezUInt32 level = 0;
+    while(level < NumLevels - 1 && (diff >> (LevelBits * (level + 1))) != 0)
+    {
+      ++level;
+    }
+
+    auto digit = static_cast<ezUInt32>(node.dueTick >> (LevelBits * level)) & (NumSlotsPerLevel - 1);
+    auto slot = level * NumSlotsPerLevel + digit;
+
+    ++this->levelCounts[level];
+    node.slot = slot;
+    node.prev = InvalidIndex;
+    node.next = this->slots[slot];
+    if(node.next != InvalidIndex)
+    {
+      this->nodes[node.next].prev = index;
+    }
+    this->slots[slot] = index;
+  }
+
+  void unlink(ezUInt32 index)
+  {
+    auto& node = this->nodes[index];
+    --this->levelCounts[node.slot / NumSlotsPerLevel];
+    if(node.prev != InvalidIndex)
+    {
+      this->nodes[node.prev].next = node.next;
+    }
+    else
+    {
+      this->slots[node.slot] = node.next;
+    }
+
+    if(node.next != InvalidIndex)
+    {
+      this->nodes[node.next].prev = node.prev;
+    }
+  }
+
+  void cascade(ezUInt32 level)
+  {
+    auto digit = static_cast<ezUInt32>(this->currentTick >> (LevelBits * level)) & (NumSlotsPerLevel - 1);
+    auto slot = level * NumSlotsPerLevel + digit;
+
+    auto index = this->slots[slot];
+    this->slots[slot] = InvalidIndex;
+    while(index != InvalidIndex)
+    {
+      auto next = this->nodes[index].next;
+      --this->levelCounts[level];
+      this->link(index);
+      index = next;
+    }
+  }
+
+  /// Events on level 0 may fire on the very next tick, events on higher
+  /// levels can only move when the lower digits of the tick roll over.
+  ezUInt64 getNextEventfulTick() const
+  {
+    for(ezUInt32 level = 0; level < NumLevels; ++level)
+    {
+      if(this->levelCounts[level] > 0)
+      {
+        auto lowerDigitsMask = (ezUInt64(1) << (LevelBits * level)) - 1;
+        return (this->currentTick | lowerDigitsMask) + 1;
+      }
+    }
+
+    return 0xFFFFFFFFFFFFFFFFull;
+  }
+
+  template<typename HANDLER>
+  void tick(HANDLER& handler)
+  {
+    ++this->currentTick;
+
+    // Higher levels first, so their events can trickle all the way down.
+    for(ezUInt32 level = NumLevels - 1; level > 0; --level)
+    {
+      auto lowerDigitsMask = (ezUInt64(1) << (LevelBits * level)) - 1;
+      if((this->currentTick & lowerDigitsMask) == 0)
+      {
+        this->cascade(level);
+      }
+    }
+
+    auto slot = static_cast<ezUInt32>(this->currentTick) & (NumSlotsPerLevel - 1);
+    auto index = this->slots[slot];
+    if(index == InvalidIndex)
+    {
+      return;
+    }
+    this->slots[slot] = InvalidIndex;
+
+    this->expired.Clear();
+    while(index != InvalidIndex)
+    {
+      auto next = this->nodes[index].next;
+      this->expired.PushBack(this->nodes[index].data);
+      --this->levelCounts[0];
+      this->freeNode(index);
+      --this->numPending;
+      index = next;
+    }
+
+    handler(ezArrayPtr<DATA>(&this->expired[0], this->expired.GetCount()));
+  }
+
+  ezTime tickDuration;
+  ezTime accumulatedTime;
+  ezUInt64 currentTick;
+  ezUInt32 numPending;
+  ezUInt32 freeList;
+  ezUInt32 levelCounts[NumLevels];
+  ezUInt32 slots[NumLevels * NumSlotsPerLevel];
+  ezDynamicArray<Node> nodes;
+  ezDynamicArray<DATA> expired;
+};
@@ -0,0 +1,288 @@
+#include <asteroids/world.h>
+#include <asteroids/asteroidField.h>
+
+#include <cmath>
+
+using namespace kr;
+
+void wrapAround(const ezRectFloat& bounds, ezVec2& position, float radius)
+{
+  auto margin = 1.1f * radius;
+  if(position.x < bounds.x - margin)                 { position.x = bounds.x + bounds.width + margin; }
+  if(position.x > bounds.x + bounds.width + margin)  { position.x = bounds.x - margin; }
+  if(position.y < bounds.y - margin)                 { position.y = bounds.y + bounds.height + margin; }
+  if(position.y > bounds.y + bounds.height + margin) { position.y = bounds.y - margin; }
+}
+
+bool overlaps(const ezRectFloat& rect, const ezVec2& center, float radius)
+{
+  auto closestX = ezMath::Clamp(center.x, rect.x, rect.x + rect.width);
+  auto closestY = ezMath::Clamp(center.y, rect.y, rect.y + rect.height);
+  auto diff = center - ezVec2(closestX, closestY);
+  return diff.GetLengthSquared() <= ezMath::Square(radius);
+}
+
+bool overlaps(const ezRectFloat& a, const ezRectFloat& b)
+{
+  return a.x <= b.x + b.width  && b.x <= a.x + a.width
+      && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+/// \brief Same as wrapAround, but for arbitrarily large distances outside of \a bounds.
+static float wrapped(float value, float min, float max)
+{
+  auto range = max - min;
+  auto offset = std::fmod(value - min, range);
+  if(offset < 0.0f)
+  {
+    offset += range;
+  }
+  return min + offset;
+}
+
+static ezInt32 chunkCoord(float value, float origin, float chunkExtent, ezInt32 numChunks)
+{
+  auto coord = static_cast<ezInt32>(std::floor((value - origin) / chunkExtent));
+  return ezMath::Clamp(coord, 0, numChunks - 1);
+}
+
+static ezInt32 chunkX(const World& world, float x)
+{
+  return chunkCoord(x, world.bounds.x, world.chunkWidth, world.numChunksX);
+}
+
+static ezInt32 chunkY(const World& world, float y)
+{
+  return chunkCoord(y, world.bounds.y, world.chunkHeight, world.numChunksY);
+}
+
+static ezUInt32 getOrCreateChunk(World& world, ezInt32 x, ezInt32 y)
+{
+  const auto key = chunkKey(x, y);
+  ezUInt32 index = 0;
+  if(world.chunkLookup.TryGetValue(key, index))
+  {
+    return index;
+  }
+
+  index = world.chunks.GetCount();
+  world.chunkLookup.Insert(key, index);
+
+  auto& chunk = world.chunks.ExpandAndGetRef();
+  chunk.x = x;
+  chunk.y = y;
+  chunk.bounds = chunkBounds(world, x, y);
+  chunk.lastUpdate = world.time;
+  return index;
+}
+
+static void insert(World& world, Asteroid asteroid)
+{
+  auto index = getOrCreateChunk(world,
+                                chunkX(world, asteroid.transform.position.x),
+                                chunkY(world, asteroid.transform.position.y));
+  auto& chunk = world.chunks[index];
+
+  // Move the asteroid back to the time of an inactive chunk,
+  // so it is not moved twice when the chunk is fast-forwarded.
+  auto behind = static_cast<float>((world.time - chunk.lastUpdate).GetSeconds());
+  asteroid.transform.position -= asteroid.linearVelocity * behind;
+
+  chunk.asteroids.PushBack(asteroid);
+}
+
+/// \brief Removes dead asteroids and moves the ones that left the chunk to their new chunk.
+static void migrateStrayAsteroids(World& world, ezUInt32 chunkIndex)
+{
+  ezUInt32 i = 0;
+  while(i < world.chunks[chunkIndex].asteroids.GetCount())
+  {
+    auto& chunk = world.chunks[chunkIndex];
+    auto asteroid = chunk.asteroids[i];
+
+    if(asteroid.isAlive()
+       && chunkX(world, asteroid.transform.position.x) == chunk.x
+       && chunkY(world, asteroid.transform.position.y) == chunk.y)
+    {
+      ++i;
+      continue;
+    }
+
+    chunk.asteroids.RemoveAtSwap(i);
+    if(asteroid.isAlive())
+    {
+      // May add chunks, so `chunk` must not be used after this.
+      insert(world, asteroid);
+    }
+  }
+}
+
+static void fastForward(World& world, WorldChunk& chunk)
+{
+  auto dt = static_cast<float>((world.time - chunk.lastUpdate).GetSeconds());
+  if(dt > 0.0f)
+  {
+    const auto& bounds = world.bounds;
+    for(auto& a : chunk.asteroids)
+    {
+      auto& pos = a.transform.position;
+      auto margin = 1.1f * a.boundingRadius;
+      pos += a.linearVelocity * dt;
+      pos.x = wrapped(pos.x, bounds.x - margin, bounds.x + bounds.width + margin);
+      pos.y = wrapped(pos.y, bounds.y - margin, bounds.y + bounds.height + margin);
+    }
+  }
+  chunk.lastUpdate = world.time;
+}
+
+static void populate(World& world, WorldChunk& chunk, const ezRectFloat& viewBounds)
+{
+  chunk.isPopulated = true;
+
+  if(world.asteroidsPerChunk == 0)
+  {
+    return;
+  }
+
+  AsteroidFieldDesc field;
+  field.bounds = chunk.bounds;
+  field.numAsteroids = world.asteroidsPerChunk;
+  field.radius = world.asteroidRadius;
+  field.minSpeed = world.minAsteroidSpeed;
+  field.maxSpeed = world.maxAsteroidSpeed;
+  field.keepOutRect = viewBounds;
+
+  // Every chunk gets its own seed so its content does not depend on the order chunks are visited in.
+  field.seed = world.seed ^ (static_cast<ezUInt32>(chunk.x) * 73856093u) ^ (static_cast<ezUInt32>(chunk.y) * 19349663u);
+  generateAsteroidField(field, chunk.asteroids);
+}
+
+ezRectFloat chunkBounds(const World& world, ezInt32 x, ezInt32 y)
+{
+  ezRectFloat bounds;
+  bounds.x = world.bounds.x + x * world.chunkWidth;
+  bounds.y = world.bounds.y + y * world.chunkHeight;
+  bounds.width = ezMath::Min(world.chunkWidth, world.bounds.x + world.bounds.width - bounds.x);
+  bounds.height = ezMath::Min(world.chunkHeight, world.bounds.y + world.bounds.height - bounds.y);
+  return bounds;
+}
+
+void initialize(World& world, const ezRectFloat& bounds, float chunkSize)
+{
+  world.bounds = bounds;
+  world.chunkWidth = chunkSize > 0.0f ? chunkSize : bounds.width;
+  world.chunkHeight = chunkSize > 0.0f ? chunkSize : bounds.height;
+  world.numChunksX = ezMath::Max(1, static_cast<ezInt32>(std::ceil(bounds.width / world.chunkWidth)));
+  world.numChunksY = ezMath::Max(1, static_cast<ezInt32>(std::ceil(bounds.height / world.chunkHeight)));
+  world.time = ezTime();
+  reset(world);
+}
+
+void reset(World& world)
+{
+  world.chunks.Clear();
+  world.activeChunks.Clear();
+  world.chunkLookup.Clear();
+}
+
+void activate(World& world, const ezRectFloat& area, const ezRectFloat& viewBounds)
+{
+  auto minX = chunkX(world, area.x);
+  auto maxX = chunkX(world, area.x + area.width);
+  auto minY = chunkY(world, area.y);
+  auto maxY = chunkY(world, area.y + area.height);
+
+  // Deactivate
+  // ==========
+  ezUInt32 i = 0;
+  while(i < world.activeChunks.GetCount())
+  {
+    auto& chunk = world.chunks[world.activeChunks[i]];
+    if(chunk.x >= minX && chunk.x <= maxX && chunk.y >= minY && chunk.y <= maxY)
+    {
+      ++i;
+      continue;
+    }
+
+    chunk.isActive = false;
+    world.activeChunks.RemoveAtSwap(i);
+  }
+
+  // Activate
+  // ========
+  auto firstNewlyActive = world.activeChunks.GetCount();
+  for(auto y = minY; y <= maxY; ++y)
+  {
+    for(auto x = minX; x <= maxX; ++x)
+    {
+      auto index = getOrCreateChunk(world, x, y);
+      auto& chunk = world.chunks[index];
+      if(chunk.isActive)
+      {
+        continue;
+      }
+
+      fastForward(world, chunk);
+      if(!chunk.isPopulated)
+      {
+        populate(world, chunk, viewBounds);
+      }
+      chunk.isActive = true;
+      world.activeChunks.PushBack(index);
+    }
+  }
+
+  // Asteroids that drifted out of their chunk while it was inactive.
+  for(auto j = firstNewlyActive; j < world.activeChunks.GetCount(); ++j)
+  {
+    migrateStrayAsteroids(world, world.activeChunks[j]);
+  }
+}
+
+void update(World& world, ezTime dt)
+{
+  world.time += dt;
+
+  auto seconds = static_cast<float>(dt.GetSeconds());
+  for(auto index : world.activeChunks)
+  {
+    auto& chunk = world.chunks[index];
+    for(auto& a : chunk.asteroids)
+    {
+      if(!a.isAlive())
+      {
+        continue;
+      }
+
+      a.transform.position += a.linearVelocity * seconds;
+      wrapAround(world.bounds, a.transform.position, a.boundingRadius);
+    }
+    chunk.lastUpdate = world.time;
+  }
+
+  for(ezUInt32 i = 0; i < world.activeChunks.GetCount(); ++i)
+  {
+    migrateStrayAsteroids(world, world.activeChunks[i]);
+  }
+}
+
+void addAsteroid(World& world, const Asteroid& asteroid)
+{
+  insert(world, asteroid);
+}
+
+ezUInt32 countLiveAsteroids(const World& world)
+{
+  ezUInt32 count = 0;
+  for(const auto& chunk : world.chunks)
+  {
+    for(const auto& a : chunk.asteroids)
+    {
+      if(a.isAlive())
+      {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
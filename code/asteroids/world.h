@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Foundation/Time/Time.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
+
+struct Asteroid
+{
+  enum { NumLives = 3, MinSpeed = 30, MaxSpeed = 200, RadiusLossPerLife = 8 };
+
+  kr::Transform2D transform = kr::Transform2D::zero();
+  ezVec2 linearVelocity = ezVec2::ZeroVector();
+  float boundingRadius = 0.0f;
+
+  int lives = NumLives;
+
+  bool isAlive() const { return this->lives > 0; }
+};
+
+/// \brief A rectangular piece of the world that is simulated as a whole.
+struct WorldChunk
+{
+  ezInt32 x = 0;
+  ezInt32 y = 0;
+  ezRectFloat bounds;
+  ezDynamicArray<Asteroid> asteroids;
+  ezTime lastUpdate; ///< World time the asteroids of this chunk are integrated to.
+  bool isActive = false;
+  bool isPopulated = false;
+};
+
+/// \brief Asteroid storage that is split into chunks around the camera.
+///
+/// Only active chunks (the ones near the camera) are simulated each frame.
+/// Inactive chunks are frozen at the time they were deactivated and fast-forwarded
+/// analytically when they become active again, which is exact since asteroids
+/// only move linearly. Chunks are created on demand and looked up by their
+/// coordinates, so only areas that were actually visited take up memory.
+///
+/// A world initialized with a chunk size of 0 consists of a single chunk covering all of it.
+struct World
+{
+  ezRectFloat bounds;
+  float chunkWidth = 0.0f;
+  float chunkHeight = 0.0f;
+  ezInt32 numChunksX = 1;
+  ezInt32 numChunksY = 1;
+
+  /// Asteroids that are streamed into a chunk the first time it becomes active.
+  ezUInt32 asteroidsPerChunk = 0;
+  float asteroidRadius = 0.0f;
+  float minAsteroidSpeed = Asteroid::MinSpeed;
+  float maxAsteroidSpeed = Asteroid::MaxSpeed;
+  ezUInt32 seed = 0;
+
+  ezTime time;
+  ezDynamicArray<WorldChunk> chunks;
+  ezHashTable<ezUInt64, ezUInt32> chunkLookup; ///< Index into chunks per chunkKey() of a visited chunk.
+  ezDynamicArray<ezUInt32> activeChunks;
+};
+
+void initialize(World& world, const ezRectFloat& bounds, float chunkSize);
+
+/// \brief Key of the chunk at \a x, \a y in World::chunkLookup.
+inline ezUInt64 chunkKey(ezInt32 x, ezInt32 y)
+{
+  return (ezUInt64(ezUInt32(y)) << 32) | ezUInt32(x);
+}
+
+/// \brief Drops all chunks, as if the world was never visited.
+void reset(World& world);
+
+/// \brief Activates all chunks overlapping \a area and deactivates all others.
+///
+/// Chunks that become active are brought up to date and populated if this is
+/// the first time they are active. Streamed in asteroids are never placed
+/// inside of \a viewBounds so they don't pop into existence on screen.
+void activate(World& world, const ezRectFloat& area, const ezRectFloat& viewBounds);
+
+/// \brief Moves all asteroids in active chunks and removes the dead ones.
+void update(World& world, ezTime dt);
+
+/// \brief Puts a copy of \a asteroid into the chunk it is located in.
+void addAsteroid(World& world, const Asteroid& asteroid);
+
+ezUInt32 countLiveAsteroids(const World& world);
+
+ezRectFloat chunkBounds(const World& world, ezInt32 x, ezInt32 y);
+
+/// \brief Wraps \a position around to the other side when leaving \a bounds by more than \a radius.
+void wrapAround(const ezRectFloat& bounds, ezVec2& position, float radius);
+
+bool overlaps(const ezRectFloat& rect, const ezVec2& center, float radius);
+bool overlaps(const ezRectFloat& a, const ezRectFloat& b);
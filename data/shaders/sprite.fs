@@ -1,13 +1,24 @@
 #version 150
 
+// Variants
+// ========
+// SPRITE_INSTANCED:  The sprite color comes from the vertex shader instead of a uniform.
+// SPRITE_ALPHA_TEST: Nearly transparent texels are discarded.
+// SPRITE_TINT:       The texture color is multiplied with the sprite color.
+
 // Uniforms
 // ========
 uniform sampler2D u_texture;
+#if defined(SPRITE_TINT) && !defined(SPRITE_INSTANCED)
 uniform vec4 u_color;
+#endif
 
 // Input
 // =====
 in vec2 fs_texCoords;
+#if defined(SPRITE_TINT) && defined(SPRITE_INSTANCED)
+in vec4 fs_color;
+#endif
 
 // Output
 // ======
@@ -18,9 +29,18 @@ out vec4 out_color;
 void main()
 {
   vec4 texColor = texture(u_texture, fs_texCoords);
+#if defined(SPRITE_ALPHA_TEST)
   if(texColor.a < 0.1)
   {
     discard;
   }
+#endif
+
+#if defined(SPRITE_TINT) && defined(SPRITE_INSTANCED)
+  out_color = texColor * fs_color;
+#elif defined(SPRITE_TINT)
   out_color = texColor * u_color;
+#else
+  out_color = texColor;
+#endif
 }
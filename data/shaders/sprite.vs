@@ -1,9 +1,16 @@
 #version 150
 
+// Variants
+// ========
+// SPRITE_INSTANCED: Origin, rotation and color come from per-instance attributes instead of uniforms.
+// SPRITE_TINT:      The texture color is multiplied with the sprite color.
+
 // Uniforms
 // ========
+#if !defined(SPRITE_INSTANCED)
 uniform vec2 u_origin;
 uniform float u_rotation; // radians
+#endif
 uniform mat4 u_view;
 uniform mat4 u_projection;
 
@@ -11,18 +18,42 @@ uniform mat4 u_projection;
 // =====
 in vec2 vs_position;
 in vec2 vs_texCoords;
+#if defined(SPRITE_INSTANCED)
+in vec2 vs_origin;
+in float vs_rotation; // radians
+  #if defined(SPRITE_TINT)
+in vec4 vs_color;
+  #endif
+#endif
 
 // Output
 // ======
 out vec2 fs_texCoords;
+#if defined(SPRITE_INSTANCED) && defined(SPRITE_TINT)
+out vec4 fs_color;
+#endif
 
 // Functions
 // =========
 void main()
 {
+#if defined(SPRITE_INSTANCED)
+  vec2 origin = vs_origin;
+  float rotation = vs_rotation;
+  #if defined(SPRITE_TINT)
+  fs_color = vs_color;
+  #endif
+#else
+  vec2 origin = u_origin;
+  float rotation = u_rotation;
+#endif
+
+  float cosRotation = cos(rotation);
+  float sinRotation = sin(rotation);
+
   vec4 transformedPos;
-  transformedPos.x = u_origin.x + vs_position.x * cos(u_rotation) - vs_position.y * sin(u_rotation);
-  transformedPos.y = u_origin.y + vs_position.x * sin(u_rotation) + vs_position.y * cos(u_rotation);
+  transformedPos.x = origin.x + vs_position.x * cosRotation - vs_position.y * sinRotation;
+  transformedPos.y = origin.y + vs_position.x * sinRotation + vs_position.y * cosRotation;
   transformedPos.z = 0.0;
   transformedPos.w = 1.0;
 